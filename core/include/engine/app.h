@@ -1,5 +1,7 @@
 #pragma once
 
+#include <SFML/Window/Event.hpp>
+
 #include "engine/system.h"
 #include "graphics/graphics.h"
 
@@ -0,0 +1,197 @@
+/**
+ * \file archetype.h
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "engine/component.h"
+#include "engine/entity.h"
+#include "utils/assert.h"
+
+namespace core
+{
+/**
+ * \brief ArchetypeStorage is a component storage that groups the entities having the same registered components (their archetype)
+ * into fixed size chunks. A chunk stores each component as a contiguous column (SoA), so a system reading a few components
+ * of all the entities of an archetype streams linearly through memory instead of indexing several arrays per entity.
+ * Components need to be trivially copyable: moving an entity between archetypes and copying the whole storage are memory copies.
+ * ForEach does not give the entities in ascending order, it should only be used by systems where the order does not matter.
+ */
+class ArchetypeStorage
+{
+public:
+    /**
+     * \brief chunkByteSize is the size in bytes of one chunk, all the columns of a chunk are stored in it.
+     */
+    static constexpr std::size_t chunkByteSize = 16u * 1024u;
+
+    /**
+     * \brief RegisterComponent is a method that declares the type of a component bit, it needs to be called before adding this component.
+     * \tparam T type of the component
+     * \param component is the unique binary flag of the component
+     */
+    template<typename T>
+    void RegisterComponent(Component component);
+    /**
+     * \brief AddComponent is a method that moves the entity to the archetype with the new component.
+     * The new component is zero initialized, the other components keep their values.
+     */
+    void AddComponent(Entity entity, Component component);
+    /**
+     * \brief RemoveComponent is a method that moves the entity to the archetype without the component.
+     */
+    void RemoveComponent(Entity entity, Component component);
+    /**
+     * \brief DestroyEntity is a method that removes all the components of the entity.
+     */
+    void DestroyEntity(Entity entity);
+    [[nodiscard]] bool HasComponent(Entity entity, Component component) const;
+    template<typename T>
+    [[nodiscard]] T& GetComponent(Entity entity, Component component);
+    template<typename T>
+    [[nodiscard]] const T& GetComponent(Entity entity, Component component) const;
+    template<typename T>
+    void SetComponent(Entity entity, Component component, const T& value) { GetComponent<T>(entity, component) = value; }
+    /**
+     * \brief ForEach is a method that calls func(entity, components...) for every entity having all the given components.
+     * It walks the chunks of every matching archetype column by column.
+     * \tparam Ts types of the components, in the same order as components
+     * \param components are the binary flags of the components
+     * \param func is the function called with the Entity and a reference to each component
+     */
+    template<typename... Ts, typename Func>
+    void ForEach(const std::array<Component, sizeof...(Ts)>& components, Func&& func);
+    /**
+     * \brief CopyAll is a method that copies all the chunks of another storage, used to save or restore a world snapshot.
+     * Both storages need the same registered components.
+     */
+    void CopyAll(const ArchetypeStorage& other);
+    /**
+     * \brief GetArchetypeCount is a method that returns the number of different archetypes created.
+     */
+    [[nodiscard]] std::size_t GetArchetypeCount() const { return archetypes_.size(); }
+    /**
+     * \brief GetEntityCount is a method that returns the number of entities having at least one registered component.
+     */
+    [[nodiscard]] std::size_t GetEntityCount() const;
+private:
+    static constexpr std::size_t componentBitNmb = sizeof(Component) * 8;
+    static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t columnAlignment = alignof(std::max_align_t);
+
+    struct Chunk
+    {
+        std::vector<std::byte> data;
+        std::vector<Entity> entities;
+    };
+    struct Archetype
+    {
+        Component mask = 0;
+        std::size_t chunkCapacity = 0;
+        /**
+         * \brief columnOffsets are the byte offsets of each component column in a chunk, indexed by component bit
+         */
+        std::array<std::size_t, componentBitNmb> columnOffsets{};
+        std::vector<Chunk> chunks;
+    };
+    struct Location
+    {
+        std::uint32_t archetype = INVALID_INDEX;
+        std::uint32_t chunk = 0;
+        std::uint32_t row = 0;
+    };
+
+    static std::size_t GetBitIndex(Component component);
+    /**
+     * \brief MoveEntity is a method that moves the entity row from its archetype to the archetype of newMask.
+     */
+    void MoveEntity(Entity entity, Component newMask);
+    std::uint32_t GetOrCreateArchetype(Component mask);
+    /**
+     * \brief PushRow is a method that adds a zeroed row for entity at the end of the archetype and returns its location.
+     */
+    Location PushRow(std::uint32_t archetypeIndex, Entity entity);
+    /**
+     * \brief EraseRow is a method that removes a row by moving the last row of the archetype in its place.
+     */
+    void EraseRow(const Location& location);
+    [[nodiscard]] std::byte* GetComponentData(const Location& location, std::size_t bitIndex);
+    [[nodiscard]] const std::byte* GetComponentData(const Location& location, std::size_t bitIndex) const;
+    [[nodiscard]] const Location& GetLocation(Entity entity) const;
+
+    std::array<std::size_t, componentBitNmb> componentSizes_{};
+    std::vector<Archetype> archetypes_;
+    std::vector<Location> locations_;
+};
+
+template<typename T>
+void ArchetypeStorage::RegisterComponent(Component component)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Archetype components are copied as raw memory");
+    static_assert(alignof(T) <= columnAlignment, "Archetype component alignment is too big");
+    gpr_assert(archetypes_.empty(), "Components need to be registered before use");
+    componentSizes_[GetBitIndex(component)] = sizeof(T);
+}
+
+template<typename T>
+T& ArchetypeStorage::GetComponent(Entity entity, Component component)
+{
+    const auto bitIndex = GetBitIndex(component);
+    gpr_assert(componentSizes_[bitIndex] == sizeof(T), "Component type does not match the registered one");
+    gpr_assert(HasComponent(entity, component), "Entity has not the requested component");
+    return *reinterpret_cast<T*>(GetComponentData(GetLocation(entity), bitIndex));
+}
+
+template<typename T>
+const T& ArchetypeStorage::GetComponent(Entity entity, Component component) const
+{
+    const auto bitIndex = GetBitIndex(component);
+    gpr_assert(componentSizes_[bitIndex] == sizeof(T), "Component type does not match the registered one");
+    gpr_assert(HasComponent(entity, component), "Entity has not the requested component");
+    return *reinterpret_cast<const T*>(GetComponentData(GetLocation(entity), bitIndex));
+}
+
+template<typename... Ts, typename Func>
+void ArchetypeStorage::ForEach(const std::array<Component, sizeof...(Ts)>& components, Func&& func)
+{
+    Component mask = 0;
+    std::array<std::size_t, sizeof...(Ts)> bitIndices{};
+    for (std::size_t i = 0; i < components.size(); i++)
+    {
+        mask |= components[i];
+        bitIndices[i] = GetBitIndex(components[i]);
+    }
+    constexpr std::array<std::size_t, sizeof...(Ts)> typeSizes{ sizeof(Ts)... };
+    for (std::size_t i = 0; i < components.size(); i++)
+    {
+        gpr_assert(componentSizes_[bitIndices[i]] == typeSizes[i], "Component type does not match the registered one");
+    }
+    for (auto& archetype : archetypes_)
+    {
+        if ((archetype.mask & mask) != mask)
+        {
+            continue;
+        }
+        for (auto& chunk : archetype.chunks)
+        {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                std::tuple<Ts*...> columns{
+                    reinterpret_cast<Ts*>(chunk.data.data() + archetype.columnOffsets[bitIndices[Is]])... };
+                for (std::size_t row = 0; row < chunk.entities.size(); row++)
+                {
+                    func(chunk.entities[row], std::get<Is>(columns)[row]...);
+                }
+            }(std::index_sequence_for<Ts...>{});
+        }
+    }
+}
+} // namespace core
@@ -2,9 +2,14 @@
 
 #include "engine/globals.h"
 #include "engine/entity.h"
+#include "engine/sparse_set.h"
 #include "utils/assert.h"
+#include "utils/profiled_allocator.h"
+#include "utils/snapshot_arena.h"
 
 #include <cstdint>
+#include <type_traits>
+#include <vector>
 
 
 namespace core
@@ -23,18 +28,39 @@ enum class ComponentType : Component
     OTHER_TYPE = 1u << 7u
 };
 
+/**
+ * \brief ComponentStorage is the storage policy of a ComponentManager.
+ * DENSE is an array indexed by Entity, sized to the highest Entity, that fits components used by most entities.
+ * SPARSE is a SparseSet, whose memory and copy scale with the number of components, that fits rare components.
+ * A SPARSE component is erased with RemoveComponent, an Entity destroyed only in the EntityManager keeps it until reused.
+ */
+enum class ComponentStorage
+{
+    DENSE,
+    SPARSE
+};
+
 /**
  * \brief ComponentManager is a class that owns Component in a contiguous array. Component indexing is done with an Entity.
  * \tparam T type of the component
  * \tparam C unique binary flag of the component. This will be set in the EntityMask of the EntityManager when added.
+ * \tparam S storage policy of the components, see ComponentStorage
  */
-template<typename T, Component C>
+template<typename T, Component C, ComponentStorage S = ComponentStorage::DENSE>
 class ComponentManager
 {
 public:
+    /**
+     * \brief Storage is the type of the internal components array, an array indexed by Entity or a SparseSet.
+     */
+    using Storage = std::conditional_t<S == ComponentStorage::DENSE, ComponentVector<T>, SparseSet<T>>;
+
     ComponentManager(EntityManager& entityManager) : entityManager_(entityManager)
     {
-        components_.resize(entityInitNmb);
+        if constexpr (S == ComponentStorage::DENSE)
+        {
+            components_.resize(entityInitNmb);
+        }
     }
     virtual ~ComponentManager() = default;
 
@@ -75,81 +101,130 @@ public:
      * \brief GetAllComponents is a method that returns the internal array of components
      * \return the internal array of components
      */
-    [[nodiscard]] const std::vector<T>& GetAllComponents() const;
+    [[nodiscard]] const Storage& GetAllComponents() const;
     /**
      * \brief CopyAllComponents is a method that changes the internal components array by copying a newly provided one.
      * It is used by the RollbackManager when reverting the current game world data with the last validated game world data.
+     * With SPARSE storage, the copy only costs the number of components.
      * \param components is the new component array to be copy instead of the old components array
      */
-    void CopyAllComponents(const std::vector<T>& components);
+    void CopyAllComponents(const Storage& components);
+    /**
+     * \brief SaveComponents is a method that writes all the components in a SnapshotArena. T needs to be trivially copyable.
+     * \param arena is the arena where the components are appended
+     */
+    void SaveComponents(SnapshotArena& arena) const;
+    /**
+     * \brief RestoreComponents is a method that reads back the components written by SaveComponents.
+     * The internal array keeps its memory, restoring a snapshot of the same size does not allocate.
+     * \param arena is the arena read from its current read position
+     */
+    void RestoreComponents(SnapshotArena& arena);
 protected:
     EntityManager& entityManager_;
-    std::vector<T> components_;
+    Storage components_;
 };
 
-template <typename T, Component C>
-void ComponentManager<T, C>::AddComponent(Entity entity)
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::AddComponent(Entity entity)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
     //Invalid entity would allocate too much memory
     if (entity == INVALID_ENTITY)
         return;
-    // Resize components array if too small
-    auto newSize = components_.size();
-    if (newSize == 0)
+    if constexpr (S == ComponentStorage::DENSE)
     {
-        newSize = 2;
+        // Resize components array if too small
+        auto newSize = components_.size();
+        if (newSize == 0)
+        {
+            newSize = 2;
+        }
+        while (entity >= newSize)
+        {
+            newSize = newSize + newSize / 2;
+        }
+        components_.resize(newSize);
     }
-    while (entity >= newSize)
+    else
     {
-        newSize = newSize + newSize / 2;
+        components_.Insert(entity);
     }
-    components_.resize(newSize);
 
     entityManager_.AddComponent(entity, C);
 }
 
-template <typename T, Component C>
-void ComponentManager<T, C>::RemoveComponent(Entity entity)
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::RemoveComponent(Entity entity)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
     gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the removing component");
+    if constexpr (S == ComponentStorage::SPARSE)
+    {
+        components_.Erase(entity);
+    }
     entityManager_.RemoveComponent(entity, C);
 }
 
-template <typename T, Component C>
-const T& ComponentManager<T, C>::GetComponent(Entity entity) const
+template <typename T, Component C, ComponentStorage S>
+const T& ComponentManager<T, C, S>::GetComponent(Entity entity) const
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
     gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
     return components_[entity];
 }
 
-template <typename T, Component C>
-T& ComponentManager<T, C>::GetComponent(Entity entity)
+template <typename T, Component C, ComponentStorage S>
+T& ComponentManager<T, C, S>::GetComponent(Entity entity)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
     gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
     return components_[entity];
 }
 
-template <typename T, Component C>
-void ComponentManager<T, C>::SetComponent(Entity entity, const T& value)
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::SetComponent(Entity entity, const T& value)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
     gpr_warn(entityManager_.HasComponent(entity, C), "Entity has not the requested component");
     components_[entity] = value;
 }
 
-template <typename T, Component C>
-const std::vector<T>& ComponentManager<T, C>::GetAllComponents() const
+template <typename T, Component C, ComponentStorage S>
+const typename ComponentManager<T, C, S>::Storage& ComponentManager<T, C, S>::GetAllComponents() const
 {
     return components_;
 }
 
-template <typename T, Component C>
-void ComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components)
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::CopyAllComponents(const Storage& components)
 {
     components_ = components;
 }
+
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::SaveComponents(SnapshotArena& arena) const
+{
+    if constexpr (S == ComponentStorage::DENSE)
+    {
+        arena.WriteVector(components_);
+    }
+    else
+    {
+        components_.Save(arena);
+    }
+}
+
+template <typename T, Component C, ComponentStorage S>
+void ComponentManager<T, C, S>::RestoreComponents(SnapshotArena& arena)
+{
+    if constexpr (S == ComponentStorage::DENSE)
+    {
+        arena.ReadVector(components_);
+    }
+    else
+    {
+        components_.Restore(arena);
+    }
+}
 } // namespace core
@@ -3,6 +3,7 @@
  */
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <limits>
@@ -10,6 +11,8 @@
 
 namespace core
 {
+class SnapshotArena;
+
 /**
  * \brief Entity is the type used to define an game world entity.
  * An Entity is just an index, it means that if you have access to a ComponentManager, you can get the Component by giving the index of the Entity.
@@ -28,8 +31,52 @@ constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
  * \brief INVALID_ENTITY_MASK is a constant that define an invalid or empty entity mask.
  */
 constexpr EntityMask INVALID_ENTITY_MASK = 0u;
+/**
+ * \brief EntityView is a range over the entities that have all the components of an include mask and none of an exclude mask.
+ * It walks the sorted entity list of the rarest included component, so its cost depends on the number of entities with this component and not on the capacity.
+ * Entities are given in ascending order, like a loop over all the entities.
+ * Adding or removing the iterated component while iterating invalidates the view, use ToVector to get a copy first.
+ */
+class EntityView
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const Entity* current, const Entity* end, const EntityMask* entityMasks, EntityMask includeMask, EntityMask excludeMask);
+        Entity operator*() const { return *current_; }
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return current_ != other.current_; }
+    private:
+        /**
+         * \brief SkipNonMatching is a method that advances the iterator to the next entity matching the masks.
+         */
+        void SkipNonMatching();
+        const Entity* current_;
+        const Entity* end_;
+        const EntityMask* entityMasks_;
+        EntityMask includeMask_;
+        EntityMask excludeMask_;
+    };
+    EntityView(const std::vector<Entity>& entities, const std::vector<EntityMask>& entityMasks, EntityMask includeMask, EntityMask excludeMask);
+    [[nodiscard]] Iterator begin() const;
+    [[nodiscard]] Iterator end() const;
+    /**
+     * \brief ToVector is a method that copies the matching entities, to iterate on them while changing their components.
+     */
+    [[nodiscard]] std::vector<Entity> ToVector() const;
+private:
+    const std::vector<Entity>& entities_;
+    const std::vector<EntityMask>& entityMasks_;
+    EntityMask includeMask_;
+    EntityMask excludeMask_;
+};
+
 /**
  * \brief Manages the entities in an array using bitwise operations to know if it has components.
+ * It also keeps for each component bit the sorted list of the entities having it, to iterate only on matching entities with View.
+ * Free entities are kept in a free-list, so that creating an entity does not scan the masks.
  */
 class EntityManager
 {
@@ -38,7 +85,7 @@ public:
     EntityManager(std::size_t reservedSize);
     /**
      * \brief CreateEntity is a method that will return the next available Entity index.
-     * It will look at the internal entityMasks_ array and give the first one that is free to use.
+     * It gives the last destroyed Entity from the free-list, or the lowest never used one.
      * If none are free, the array is reallocated.
      * \return the newly created Entity
      */
@@ -81,10 +128,78 @@ public:
      * \return the total size of the EntityMask array.
      */
     [[nodiscard]] std::size_t GetEntitiesSize() const;
-
+    /**
+     * \brief GetEntityCount is a method that returns the number of existing entities, without iterating on them.
+     */
+    [[nodiscard]] std::size_t GetEntityCount() const;
+    /**
+     * \brief GetEntityCount is a method that returns the number of entities having a component, without iterating on them.
+     * \param component is a single Component bit
+     */
+    [[nodiscard]] std::size_t GetEntityCount(EntityMask component) const;
+    /**
+     * \brief GetAllEntityMasks is a method that returns the internal EntityMask array.
+     * \return the internal EntityMask array.
+     */
+    [[nodiscard]] const std::vector<EntityMask>& GetAllEntityMasks() const;
+    /**
+     * \brief CopyAllEntityMasks is a method that replaces the internal EntityMask array by copying a newly provided one.
+     * It is used to mirror the entities of one world in another one (for example from the simulation to the rendering).
+     * \param entityMasks is the new EntityMask array to be copied instead of the old one
+     */
+    void CopyAllEntityMasks(const std::vector<EntityMask>& entityMasks);
+    /**
+     * \brief SaveEntities is a method that writes the entity masks, the free-list and the component lists in a SnapshotArena.
+     * Restoring them gives back the same entities and the same next created entities, it is used by the rollback.
+     * \param arena is the arena where the entities are appended
+     */
+    void SaveEntities(SnapshotArena& arena) const;
+    /**
+     * \brief RestoreEntities is a method that reads back the entities written by SaveEntities, without scanning the masks.
+     * \param arena is the arena read from its current read position
+     */
+    void RestoreEntities(SnapshotArena& arena);
+    /**
+     * \brief View is a method that returns the entities that have all the components of includeMask and none of excludeMask.
+     * \param includeMask is the Component bitwise mask that the entities need to have, it cannot be empty
+     * \param excludeMask is the Component bitwise mask that the entities cannot have
+     * \return a range of the matching entities in ascending order
+     */
+    [[nodiscard]] EntityView View(EntityMask includeMask, EntityMask excludeMask = INVALID_ENTITY_MASK) const;
+    /**
+     * \brief View is a method that returns the entities that have all the given components.
+     * \tparam Components are the component types (core::ComponentType or any other component enum) needed
+     */
+    template<auto... Components>
+    [[nodiscard]] EntityView View() const
+    {
+        return View((static_cast<EntityMask>(Components) | ...));
+    }
 
 private:
+    static constexpr std::size_t entityMaskBitNmb = sizeof(EntityMask) * 8;
+    /**
+     * \brief AddToComponentLists is a method that inserts the entity in the sorted list of each bit of mask.
+     */
+    void AddToComponentLists(Entity entity, EntityMask mask);
+    /**
+     * \brief RemoveFromComponentLists is a method that erases the entity from the sorted list of each bit of mask.
+     */
+    void RemoveFromComponentLists(Entity entity, EntityMask mask);
+    /**
+     * \brief Grow is a method that resizes the entityMasks_ array and adds the new entities to the free-list.
+     */
+    void Grow(std::size_t newSize);
+
     std::vector<EntityMask> entityMasks_;
+    /**
+     * \brief freeEntities_ is the free-list of entities, the next created one is at the back
+     */
+    std::vector<Entity> freeEntities_;
+    /**
+     * \brief componentEntities_ is the sorted list of the entities having a component bit, for each bit of EntityMask
+     */
+    std::array<std::vector<Entity>, entityMaskBitNmb> componentEntities_{};
 };
 
 } // namespace core
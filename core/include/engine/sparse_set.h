@@ -0,0 +1,155 @@
+/**
+ * \file sparse_set.h
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "engine/entity.h"
+#include "utils/assert.h"
+#include "utils/profiled_allocator.h"
+#include "utils/snapshot_arena.h"
+
+namespace core
+{
+/**
+ * \brief SparseSet is a container that stores values packed in a dense array, with a sparse array giving the dense index of each Entity.
+ * An entry of the sparse array is only valid if the dense entity at its index is the same entity, so the sparse array is never cleared.
+ * Copying a SparseSet into another one thus only costs the number of stored values, not the highest Entity ever used.
+ * \tparam T type of the stored values
+ */
+template<typename T>
+class SparseSet
+{
+public:
+    SparseSet() = default;
+    SparseSet(const SparseSet& other) = default;
+    SparseSet(SparseSet&& other) noexcept = default;
+    SparseSet& operator=(SparseSet&& other) noexcept = default;
+    ~SparseSet() = default;
+    /**
+     * \brief The copy only copies the dense arrays and points the sparse entries of the copied entities to them.
+     */
+    SparseSet& operator=(const SparseSet& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+        if (sparse_.size() < other.sparse_.size())
+        {
+            sparse_.resize(other.sparse_.size(), INVALID_INDEX);
+        }
+        dense_ = other.dense_;
+        denseEntities_ = other.denseEntities_;
+        for (std::size_t i = 0; i < denseEntities_.size(); i++)
+        {
+            sparse_[denseEntities_[i]] = static_cast<std::uint32_t>(i);
+        }
+        return *this;
+    }
+    [[nodiscard]] bool Contains(Entity entity) const
+    {
+        return entity < sparse_.size() &&
+            sparse_[entity] < denseEntities_.size() &&
+            denseEntities_[sparse_[entity]] == entity;
+    }
+    /**
+     * \brief Insert is a method that adds a default value for the entity, or keeps the current one if it is already stored.
+     * \return a reference to the value of the entity
+     */
+    T& Insert(Entity entity)
+    {
+        gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+        if (Contains(entity))
+        {
+            return dense_[sparse_[entity]];
+        }
+        if (entity >= sparse_.size())
+        {
+            sparse_.resize(static_cast<std::size_t>(entity) + 1 + entity / 2, INVALID_INDEX);
+        }
+        sparse_[entity] = static_cast<std::uint32_t>(denseEntities_.size());
+        denseEntities_.push_back(entity);
+        return dense_.emplace_back();
+    }
+    /**
+     * \brief Erase is a method that removes the value of the entity by moving the last value in its place.
+     */
+    void Erase(Entity entity)
+    {
+        if (!Contains(entity))
+        {
+            return;
+        }
+        const auto index = sparse_[entity];
+        const auto lastEntity = denseEntities_.back();
+        dense_[index] = std::move(dense_.back());
+        denseEntities_[index] = lastEntity;
+        sparse_[lastEntity] = index;
+        dense_.pop_back();
+        denseEntities_.pop_back();
+    }
+    /**
+     * \brief Accessing an entity that is not stored only warns, like a dense component array:
+     * the entity gets a default value that is kept until it is erased.
+     */
+    [[nodiscard]] T& operator[](Entity entity)
+    {
+        gpr_warn(Contains(entity), "Entity is not in the sparse set");
+        return Insert(entity);
+    }
+    /**
+     * \brief Reading an entity that is not stored only warns, like a dense component array, and returns a default value.
+     */
+    [[nodiscard]] const T& operator[](Entity entity) const
+    {
+        if (!Contains(entity))
+        {
+            gpr_warn(false, "Entity is not in the sparse set");
+            static const T defaultValue{};
+            return defaultValue;
+        }
+        return dense_[sparse_[entity]];
+    }
+    /**
+     * \brief GetSize is a method that returns the number of stored values.
+     */
+    [[nodiscard]] std::size_t GetSize() const { return dense_.size(); }
+    [[nodiscard]] const ComponentVector<T>& GetDenseValues() const { return dense_; }
+    [[nodiscard]] const ComponentVector<Entity>& GetDenseEntities() const { return denseEntities_; }
+    /**
+     * \brief Save is a method that writes the dense arrays in the arena, the sparse array is rebuilt by Restore.
+     */
+    void Save(SnapshotArena& arena) const
+    {
+        arena.WriteVector(dense_);
+        arena.WriteVector(denseEntities_);
+    }
+    /**
+     * \brief Restore is a method that reads back the dense arrays written by Save and points the sparse entries to them.
+     */
+    void Restore(SnapshotArena& arena)
+    {
+        arena.ReadVector(dense_);
+        arena.ReadVector(denseEntities_);
+        for (std::size_t i = 0; i < denseEntities_.size(); i++)
+        {
+            const auto entity = denseEntities_[i];
+            if (entity >= sparse_.size())
+            {
+                sparse_.resize(static_cast<std::size_t>(entity) + 1 + entity / 2, INVALID_INDEX);
+            }
+            sparse_[entity] = static_cast<std::uint32_t>(i);
+        }
+    }
+private:
+    static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+    ComponentVector<T> dense_;
+    ComponentVector<Entity> denseEntities_;
+    ComponentVector<std::uint32_t> sparse_;
+};
+} // namespace core
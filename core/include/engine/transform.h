@@ -46,17 +46,41 @@ public:
     TransformManager(EntityManager& entityManager);
 
     [[nodiscard]] Vec2f GetPosition(Entity entity) const;
-    [[nodiscard]] const std::vector<Vec2f>& GetAllPositions() const;
+    [[nodiscard]] const ComponentVector<Vec2f>& GetAllPositions() const;
     void SetPosition(Entity entity, Vec2f position);
 
     [[nodiscard]] Vec2f GetScale(Entity entity) const;
-    [[nodiscard]] const std::vector<Vec2f>& GetAllScales() const;
+    [[nodiscard]] const ComponentVector<Vec2f>& GetAllScales() const;
     void SetScale(Entity entity, Vec2f scale);
 
     [[nodiscard]] Degree GetRotation(Entity entity) const;
-    [[nodiscard]] const std::vector<Degree>& GetAllRotations() const;
+    [[nodiscard]] const ComponentVector<Degree>& GetAllRotations() const;
     void SetRotation(Entity entity, Degree rotation);
 
+    /**
+     * \brief CopyAllPositions is a method that replaces all the positions by copying a newly provided array.
+     * \param positions is the new position array
+     */
+    void CopyAllPositions(const ComponentVector<Vec2f>& positions);
+    /**
+     * \brief CopyAllScales is a method that replaces all the scales by copying a newly provided array.
+     * \param scales is the new scale array
+     */
+    void CopyAllScales(const ComponentVector<Vec2f>& scales);
+    /**
+     * \brief CopyAllRotations is a method that replaces all the rotations by copying a newly provided array.
+     * \param rotations is the new rotation array
+     */
+    void CopyAllRotations(const ComponentVector<Degree>& rotations);
+    /**
+     * \brief SaveComponents is a method that writes the positions, scales and rotations in a SnapshotArena.
+     */
+    void SaveComponents(SnapshotArena& arena) const;
+    /**
+     * \brief RestoreComponents is a method that reads back the positions, scales and rotations written by SaveComponents.
+     */
+    void RestoreComponents(SnapshotArena& arena);
+
     void AddComponent(Entity entity);
     void RemoveComponent(Entity entity);
     
@@ -3,6 +3,10 @@
 #include "engine/component.h"
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <utility>
+#include <vector>
 
 #include "graphics.h"
 
@@ -13,6 +17,8 @@ class TransformManager;
 /**
  * \brief SpriteManager is a ComponentManager that manages sprites, order by greater entity index, background entity < foreground entity
  * Positions are centered at the center of the render target and use pixelPerMeter from globals.h
+ * When batching is enabled (default), sprites sharing a texture are drawn in one draw call using a vertex array of textured quads.
+ * The order is then kept between the sprites of the same texture, and textures are drawn in order of their first sprite.
  */
 class SpriteManager :
     public ComponentManager<sf::Sprite, static_cast<Component>(ComponentType::SPRITE)>,
@@ -31,11 +37,30 @@ public:
     void SetWindowSize(sf::Vector2f newWindowSize) { windowSize_ = newWindowSize; }
     void Draw(sf::RenderTarget& window) override;
     void SetColor(Entity entity, sf::Color color);
+    /**
+     * \brief SetBatching is a method that chooses between one draw call per texture (true) and one draw call per sprite (false).
+     */
+    void SetBatching(bool isBatching) { isBatching_ = isBatching; }
+    [[nodiscard]] bool IsBatching() const { return isBatching_; }
 
 protected:
+    /**
+     * \brief UpdateSpriteTransform is a method that applies the transform components of the entity to its sprite.
+     */
+    void UpdateSpriteTransform(Entity entity);
+    /**
+     * \brief AppendToBatch is a method that adds the two triangles of the sprite quad to the vertex array of its texture.
+     */
+    void AppendToBatch(const sf::Sprite& sprite);
+
     TransformManager& transformManager_;
     sf::Vector2f center_{};
     sf::Vector2f windowSize_{};
+    /**
+     * \brief batches_ are the vertex arrays per texture, kept between frames to reuse their memory.
+     */
+    std::vector<std::pair<const sf::Texture*, sf::VertexArray>> batches_;
+    bool isBatching_ = true;
 
 };
 
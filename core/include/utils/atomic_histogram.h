@@ -0,0 +1,96 @@
+/**
+ * \file atomic_histogram.h
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace core
+{
+/**
+ * \brief AtomicHistogram is an utility class that counts unsigned values in power of two buckets without any lock.
+ * Bucket 0 counts the zeros, bucket i counts the values in [2^(i-1), 2^i) and the last bucket counts all the larger values.
+ * Values can be added from any thread and read from another one, the reads are not a consistent snapshot of all the buckets.
+ * \tparam BucketNmb number of buckets, the last one is unbounded
+ */
+template<std::size_t BucketNmb>
+class AtomicHistogram
+{
+public:
+    static_assert(BucketNmb > 1, "AtomicHistogram needs at least two buckets");
+    void Add(std::uint64_t value)
+    {
+        buckets_[GetBucket(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while (max < value && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+    void Reset()
+    {
+        for (auto& bucket : buckets_)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+    [[nodiscard]] static constexpr std::size_t GetBucketNmb() { return BucketNmb; }
+    [[nodiscard]] static constexpr std::size_t GetBucket(std::uint64_t value)
+    {
+        return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(value)), BucketNmb - 1);
+    }
+    /**
+     * \brief GetBucketMin is a method that returns the smallest value counted in a bucket.
+     */
+    [[nodiscard]] static constexpr std::uint64_t GetBucketMin(std::size_t bucket)
+    {
+        return bucket == 0 ? 0 : std::uint64_t{ 1 } << (bucket - 1);
+    }
+    [[nodiscard]] std::uint64_t GetBucketCount(std::size_t bucket) const { return buckets_[bucket].load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t GetSum() const { return sum_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t GetMax() const { return max_.load(std::memory_order_relaxed); }
+    [[nodiscard]] double GetMean() const
+    {
+        const auto count = GetCount();
+        return count == 0 ? 0.0 : static_cast<double>(GetSum()) / static_cast<double>(count);
+    }
+    /**
+     * \brief GetPercentile is a method that returns an upper bound of the given percentile, the end of the bucket that contains it.
+     * \param percentile is in [0, 1]
+     * \return the first value after the bucket, or the maximum value for the last bucket
+     */
+    [[nodiscard]] std::uint64_t GetPercentile(double percentile) const
+    {
+        const auto count = GetCount();
+        if (count == 0)
+        {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(percentile * static_cast<double>(count));
+        std::uint64_t cumulativeCount = 0;
+        for (std::size_t bucket = 0; bucket < BucketNmb - 1; bucket++)
+        {
+            cumulativeCount += GetBucketCount(bucket);
+            if (cumulativeCount > rank)
+            {
+                return GetBucketMin(bucket + 1);
+            }
+        }
+        return GetMax();
+    }
+private:
+    std::array<std::atomic<std::uint64_t>, BucketNmb> buckets_{};
+    std::atomic<std::uint64_t> count_ = 0;
+    std::atomic<std::uint64_t> sum_ = 0;
+    std::atomic<std::uint64_t> max_ = 0;
+};
+}
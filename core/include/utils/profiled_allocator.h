@@ -0,0 +1,66 @@
+/**
+ * \file profiled_allocator.h
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace core
+{
+/**
+ * \brief componentMemoryName is the Tracy memory pool of the component arrays.
+ */
+inline constexpr char componentMemoryName[] = "Components";
+
+#ifdef TRACY_ENABLE
+/**
+ * \brief ProfiledAllocator is an allocator that reports its allocations and frees to Tracy, in the memory pool Name.
+ * \tparam T type of the allocated objects
+ * \tparam Name name of the Tracy memory pool, it needs a static storage as Tracy keeps the pointer
+ */
+template<typename T, const char* Name>
+class ProfiledAllocator
+{
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = ProfiledAllocator<U, Name>;
+    };
+
+    ProfiledAllocator() noexcept = default;
+    template<typename U>
+    ProfiledAllocator(const ProfiledAllocator<U, Name>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        T* ptr = std::allocator<T>{}.allocate(n);
+        TracyAllocN(ptr, n * sizeof(T), Name);
+        return ptr;
+    }
+    void deallocate(T* ptr, std::size_t n)
+    {
+        TracyFreeN(ptr, Name);
+        std::allocator<T>{}.deallocate(ptr, n);
+    }
+    template<typename U>
+    bool operator==(const ProfiledAllocator<U, Name>&) const noexcept { return true; }
+};
+
+/**
+ * \brief ComponentVector is the array of a ComponentManager, its memory is tracked by Tracy.
+ */
+template<typename T>
+using ComponentVector = std::vector<T, ProfiledAllocator<T, componentMemoryName>>;
+#else
+template<typename T>
+using ComponentVector = std::vector<T>;
+#endif
+}
@@ -0,0 +1,145 @@
+/**
+ * \file snapshot_arena.h
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief SnapshotArena is an utility class that serializes trivially copyable data one after the other in one contiguous byte buffer.
+ * Data is read back in the same order it was written. Clearing the arena keeps its memory,
+ * so writing a snapshot of the same size every frame does not allocate.
+ * Reading past the end fails without copying anything, and all the next reads fail until the arena is rewound,
+ * so that a truncated or corrupted snapshot loaded from a file or received from the network is detected once restored.
+ */
+class SnapshotArena
+{
+public:
+    /**
+     * \brief Clear is a method that empties the arena without releasing its memory.
+     */
+    void Clear()
+    {
+        buffer_.clear();
+        Rewind();
+    }
+    /**
+     * \brief Rewind is a method that moves the read cursor back to the beginning of the arena and clears the read error.
+     */
+    void Rewind()
+    {
+        readOffset_ = 0;
+        hasReadError_ = false;
+    }
+    template<typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot data is copied as raw memory");
+        WriteBytes(&value, sizeof(T));
+    }
+    /**
+     * \brief WriteVector is a method that writes the size of the vector followed by all its values.
+     */
+    template<typename T, typename Allocator>
+    void WriteVector(const std::vector<T, Allocator>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot data is copied as raw memory");
+        Write(values.size());
+        WriteBytes(values.data(), values.size() * sizeof(T));
+    }
+    /**
+     * \brief Read is a method that copies the next value of the arena.
+     * \return false if the arena has not enough data left, the value is then left unchanged
+     */
+    template<typename T>
+    bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot data is copied as raw memory");
+        return ReadBytes(&value, sizeof(T));
+    }
+    /**
+     * \brief ReadVector is a method that resizes the vector to the written size and copies the values in it.
+     * The vector keeps its memory if it is big enough.
+     * \return false if the written size is bigger than the data left, the vector is then cleared
+     */
+    template<typename T, typename Allocator>
+    bool ReadVector(std::vector<T, Allocator>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot data is copied as raw memory");
+        std::size_t size = 0;
+        //The size is checked before resizing, a corrupted size would allocate any amount of memory
+        if (!Read(size) || size > (buffer_.size() - readOffset_) / sizeof(T))
+        {
+            hasReadError_ = true;
+            values.clear();
+            return false;
+        }
+        values.resize(size);
+        return ReadBytes(values.data(), size * sizeof(T));
+    }
+    /**
+     * \brief CopyAll is a method that copies the content of another arena, reusing the memory of this one.
+     */
+    void CopyAll(const SnapshotArena& other)
+    {
+        buffer_.assign(other.buffer_.begin(), other.buffer_.end());
+        Rewind();
+    }
+    /**
+     * \brief CopyBytes is a method that replaces the content of the arena by bytes written by another arena, for example loaded from a file.
+     */
+    void CopyBytes(const std::byte* data, std::size_t size)
+    {
+        buffer_.assign(data, data + size);
+        Rewind();
+    }
+    /**
+     * \brief GetSize is a method that returns the number of written bytes.
+     */
+    [[nodiscard]] std::size_t GetSize() const { return buffer_.size(); }
+    [[nodiscard]] const std::byte* GetData() const { return buffer_.data(); }
+    /**
+     * \brief IsAtEnd is a method that returns if all the written data has been read.
+     */
+    [[nodiscard]] bool IsAtEnd() const { return readOffset_ == buffer_.size(); }
+    /**
+     * \brief HasReadError is a method that returns if a read failed since the last rewind.
+     */
+    [[nodiscard]] bool HasReadError() const { return hasReadError_; }
+private:
+    void WriteBytes(const void* data, std::size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        const auto offset = buffer_.size();
+        buffer_.resize(offset + size);
+        std::memcpy(buffer_.data() + offset, data, size);
+    }
+    bool ReadBytes(void* data, std::size_t size)
+    {
+        if (hasReadError_ || size > buffer_.size() - readOffset_)
+        {
+            hasReadError_ = true;
+            return false;
+        }
+        if (size == 0)
+        {
+            return true;
+        }
+        std::memcpy(data, buffer_.data() + readOffset_, size);
+        readOffset_ += size;
+        return true;
+    }
+
+    std::vector<std::byte> buffer_;
+    std::size_t readOffset_ = 0;
+    bool hasReadError_ = false;
+};
+} // namespace core
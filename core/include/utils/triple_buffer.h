@@ -0,0 +1,65 @@
+/**
+ * \file triple_buffer.h
+ */
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <utility>
+
+namespace core
+{
+/**
+ * \brief TripleBuffer is an utility class that allows one producer thread to publish data to one consumer thread without ever waiting on it.
+ * The producer writes in its own buffer and publishes it, the consumer acquires the last published buffer and reads it.
+ * Only the swap of the buffer indices is protected, the data itself is never copied.
+ * \tparam T type of the published data
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * \brief GetWriteBuffer is a method that returns the buffer owned by the producer.
+     * \return the buffer to write the next data in.
+     */
+    [[nodiscard]] T& GetWriteBuffer() { return buffers_[writeIndex_]; }
+    /**
+     * \brief Publish is a method called by the producer to make the write buffer available to the consumer.
+     * The producer gets the old middle buffer as its new write buffer.
+     */
+    void Publish()
+    {
+        std::scoped_lock lock(mutex_);
+        std::swap(writeIndex_, middleIndex_);
+        isFresh_ = true;
+    }
+    /**
+     * \brief Acquire is a method called by the consumer to get the last published buffer.
+     * \return true if a new buffer was published since the last call, false if the read buffer did not change.
+     */
+    bool Acquire()
+    {
+        std::scoped_lock lock(mutex_);
+        if (!isFresh_)
+        {
+            return false;
+        }
+        std::swap(readIndex_, middleIndex_);
+        isFresh_ = false;
+        return true;
+    }
+    /**
+     * \brief GetReadBuffer is a method that returns the buffer owned by the consumer.
+     * \return the last acquired buffer.
+     */
+    [[nodiscard]] const T& GetReadBuffer() const { return buffers_[readIndex_]; }
+private:
+    std::array<T, 3> buffers_{};
+    std::size_t writeIndex_ = 0;
+    std::size_t middleIndex_ = 1;
+    std::size_t readIndex_ = 2;
+    bool isFresh_ = false;
+    std::mutex mutex_;
+};
+} // namespace core
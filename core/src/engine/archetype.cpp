@@ -0,0 +1,223 @@
+#include "engine/archetype.h"
+
+#include <bit>
+#include <cstring>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace core
+{
+void ArchetypeStorage::AddComponent(Entity entity, Component component)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    gpr_assert(componentSizes_[GetBitIndex(component)] != 0, "Component is not registered");
+    if (HasComponent(entity, component))
+    {
+        return;
+    }
+    Component mask = 0;
+    if (entity < locations_.size() && locations_[entity].archetype != INVALID_INDEX)
+    {
+        mask = archetypes_[locations_[entity].archetype].mask;
+    }
+    MoveEntity(entity, mask | component);
+}
+
+void ArchetypeStorage::RemoveComponent(Entity entity, Component component)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    if (!HasComponent(entity, component))
+    {
+        return;
+    }
+    MoveEntity(entity, archetypes_[locations_[entity].archetype].mask & ~component);
+}
+
+void ArchetypeStorage::DestroyEntity(Entity entity)
+{
+    gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    if (entity >= locations_.size() || locations_[entity].archetype == INVALID_INDEX)
+    {
+        return;
+    }
+    EraseRow(locations_[entity]);
+    locations_[entity] = {};
+}
+
+bool ArchetypeStorage::HasComponent(Entity entity, Component component) const
+{
+    if (entity >= locations_.size() || locations_[entity].archetype == INVALID_INDEX)
+    {
+        return false;
+    }
+    return (archetypes_[locations_[entity].archetype].mask & component) == component;
+}
+
+void ArchetypeStorage::CopyAll(const ArchetypeStorage& other)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    gpr_assert(componentSizes_ == other.componentSizes_, "Archetype storages have different components");
+    //Reuses the already allocated chunks when the archetypes are the same
+    archetypes_ = other.archetypes_;
+    locations_ = other.locations_;
+}
+
+std::size_t ArchetypeStorage::GetEntityCount() const
+{
+    std::size_t count = 0;
+    for (const auto& archetype : archetypes_)
+    {
+        for (const auto& chunk : archetype.chunks)
+        {
+            count += chunk.entities.size();
+        }
+    }
+    return count;
+}
+
+std::size_t ArchetypeStorage::GetBitIndex(Component component)
+{
+    gpr_assert(std::has_single_bit(component), "Component needs to be a single bit");
+    return static_cast<std::size_t>(std::countr_zero(component));
+}
+
+void ArchetypeStorage::MoveEntity(Entity entity, Component newMask)
+{
+    if (entity >= locations_.size())
+    {
+        locations_.resize(static_cast<std::size_t>(entity) + 1 + entity / 2);
+    }
+    const auto oldLocation = locations_[entity];
+    if (newMask == 0)
+    {
+        DestroyEntity(entity);
+        return;
+    }
+    const auto newArchetypeIndex = GetOrCreateArchetype(newMask);
+    const auto newLocation = PushRow(newArchetypeIndex, entity);
+    if (oldLocation.archetype != INVALID_INDEX)
+    {
+        //Copy the components kept by the new archetype, then remove the old row
+        for (auto mask = archetypes_[oldLocation.archetype].mask & newMask; mask != 0; mask &= mask - 1)
+        {
+            const auto bitIndex = static_cast<std::size_t>(std::countr_zero(mask));
+            std::memcpy(GetComponentData(newLocation, bitIndex),
+                GetComponentData(oldLocation, bitIndex),
+                componentSizes_[bitIndex]);
+        }
+        EraseRow(oldLocation);
+    }
+    locations_[entity] = newLocation;
+}
+
+std::uint32_t ArchetypeStorage::GetOrCreateArchetype(Component mask)
+{
+    for (std::size_t i = 0; i < archetypes_.size(); i++)
+    {
+        if (archetypes_[i].mask == mask)
+        {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+    Archetype archetype;
+    archetype.mask = mask;
+    std::size_t rowSize = 0;
+    std::size_t columnNmb = 0;
+    for (auto componentMask = mask; componentMask != 0; componentMask &= componentMask - 1)
+    {
+        rowSize += componentSizes_[std::countr_zero(componentMask)];
+        columnNmb++;
+    }
+    //Each column can lose up to columnAlignment bytes to be aligned
+    archetype.chunkCapacity = (chunkByteSize - columnNmb * columnAlignment) / rowSize;
+    gpr_assert(archetype.chunkCapacity > 0, "Archetype row is bigger than a chunk");
+    std::size_t offset = 0;
+    for (auto componentMask = mask; componentMask != 0; componentMask &= componentMask - 1)
+    {
+        const auto bitIndex = static_cast<std::size_t>(std::countr_zero(componentMask));
+        archetype.columnOffsets[bitIndex] = offset;
+        offset += componentSizes_[bitIndex] * archetype.chunkCapacity;
+        offset = (offset + columnAlignment - 1) / columnAlignment * columnAlignment;
+    }
+    archetypes_.push_back(std::move(archetype));
+    return static_cast<std::uint32_t>(archetypes_.size() - 1);
+}
+
+ArchetypeStorage::Location ArchetypeStorage::PushRow(std::uint32_t archetypeIndex, Entity entity)
+{
+    auto& archetype = archetypes_[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().entities.size() == archetype.chunkCapacity)
+    {
+        Chunk chunk;
+        chunk.data.resize(chunkByteSize);
+        chunk.entities.reserve(archetype.chunkCapacity);
+        archetype.chunks.push_back(std::move(chunk));
+    }
+    auto& chunk = archetype.chunks.back();
+    const Location location{
+        archetypeIndex,
+        static_cast<std::uint32_t>(archetype.chunks.size() - 1),
+        static_cast<std::uint32_t>(chunk.entities.size()) };
+    chunk.entities.push_back(entity);
+    for (auto mask = archetype.mask; mask != 0; mask &= mask - 1)
+    {
+        const auto bitIndex = static_cast<std::size_t>(std::countr_zero(mask));
+        std::memset(GetComponentData(location, bitIndex), 0, componentSizes_[bitIndex]);
+    }
+    return location;
+}
+
+void ArchetypeStorage::EraseRow(const Location& location)
+{
+    auto& archetype = archetypes_[location.archetype];
+    auto& lastChunk = archetype.chunks.back();
+    const Location lastLocation{
+        location.archetype,
+        static_cast<std::uint32_t>(archetype.chunks.size() - 1),
+        static_cast<std::uint32_t>(lastChunk.entities.size() - 1) };
+    if (location.chunk != lastLocation.chunk || location.row != lastLocation.row)
+    {
+        //Keep the chunks packed by moving the last row in the erased one
+        for (auto mask = archetype.mask; mask != 0; mask &= mask - 1)
+        {
+            const auto bitIndex = static_cast<std::size_t>(std::countr_zero(mask));
+            std::memcpy(GetComponentData(location, bitIndex),
+                GetComponentData(lastLocation, bitIndex),
+                componentSizes_[bitIndex]);
+        }
+        const auto movedEntity = lastChunk.entities.back();
+        archetype.chunks[location.chunk].entities[location.row] = movedEntity;
+        locations_[movedEntity] = location;
+    }
+    lastChunk.entities.pop_back();
+    if (lastChunk.entities.empty())
+    {
+        archetype.chunks.pop_back();
+    }
+}
+
+std::byte* ArchetypeStorage::GetComponentData(const Location& location, std::size_t bitIndex)
+{
+    auto& archetype = archetypes_[location.archetype];
+    return archetype.chunks[location.chunk].data.data() +
+        archetype.columnOffsets[bitIndex] + location.row * componentSizes_[bitIndex];
+}
+
+const std::byte* ArchetypeStorage::GetComponentData(const Location& location, std::size_t bitIndex) const
+{
+    const auto& archetype = archetypes_[location.archetype];
+    return archetype.chunks[location.chunk].data.data() +
+        archetype.columnOffsets[bitIndex] + location.row * componentSizes_[bitIndex];
+}
+
+const ArchetypeStorage::Location& ArchetypeStorage::GetLocation(Entity entity) const
+{
+    gpr_assert(entity < locations_.size(), "Entity is not in the archetype storage");
+    return locations_[entity];
+}
+}
@@ -1,61 +1,116 @@
 #include "engine/entity.h"
 #include "engine/component.h"
 #include "utils/assert.h"
+#include "utils/snapshot_arena.h"
 
 #include <algorithm>
+#include <bit>
 
 namespace core
 {
+EntityView::Iterator::Iterator(const Entity* current, const Entity* end, const EntityMask* entityMasks,
+    EntityMask includeMask, EntityMask excludeMask) :
+    current_(current), end_(end), entityMasks_(entityMasks), includeMask_(includeMask), excludeMask_(excludeMask)
+{
+    SkipNonMatching();
+}
+
+EntityView::Iterator& EntityView::Iterator::operator++()
+{
+    ++current_;
+    SkipNonMatching();
+    return *this;
+}
+
+void EntityView::Iterator::SkipNonMatching()
+{
+    while (current_ != end_)
+    {
+        const auto entityMask = entityMasks_[*current_];
+        if ((entityMask & includeMask_) == includeMask_ && (entityMask & excludeMask_) == 0)
+        {
+            return;
+        }
+        ++current_;
+    }
+}
+
+EntityView::EntityView(const std::vector<Entity>& entities, const std::vector<EntityMask>& entityMasks,
+    EntityMask includeMask, EntityMask excludeMask) :
+    entities_(entities), entityMasks_(entityMasks), includeMask_(includeMask), excludeMask_(excludeMask)
+{
+}
+
+EntityView::Iterator EntityView::begin() const
+{
+    return { entities_.data(), entities_.data() + entities_.size(), entityMasks_.data(), includeMask_, excludeMask_ };
+}
+
+EntityView::Iterator EntityView::end() const
+{
+    const auto* end = entities_.data() + entities_.size();
+    return { end, end, entityMasks_.data(), includeMask_, excludeMask_ };
+}
+
+std::vector<Entity> EntityView::ToVector() const
+{
+    std::vector<Entity> entities;
+    for (const auto entity : *this)
+    {
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
 EntityManager::EntityManager()
 {
-    entityMasks_.resize(entityInitNmb, INVALID_ENTITY_MASK);
+    Grow(entityInitNmb);
 }
 
 EntityManager::EntityManager(std::size_t reservedSize)
 {
-    entityMasks_.resize(reservedSize, INVALID_ENTITY_MASK);
+    Grow(reservedSize);
 }
 
 Entity EntityManager::CreateEntity()
 {
-    const auto entityMaskIt = std::find_if(entityMasks_.begin(), entityMasks_.end(),
-        [](EntityMask entityMask)
-        {
-            return entityMask == INVALID_ENTITY_MASK;
-        });
-
-    if (entityMaskIt == entityMasks_.end())
+    //Entries can be stale if an entity was destroyed twice
+    while (!freeEntities_.empty() && entityMasks_[freeEntities_.back()] != INVALID_ENTITY_MASK)
+    {
+        freeEntities_.pop_back();
+    }
+    if (freeEntities_.empty())
     {
-        const auto newEntity = entityMasks_.size();
-        entityMasks_.resize(newEntity + newEntity / 2, INVALID_ENTITY_MASK);
-        AddComponent(
-            static_cast<Entity>(newEntity),
-            static_cast<EntityMask>(ComponentType::EMPTY));
-        return static_cast<Entity>(newEntity);
+        const auto size = entityMasks_.size();
+        Grow(size < 2 ? 2 : size + size / 2);
     }
-    
-    const auto newEntity = std::distance(entityMasks_.begin(), entityMaskIt);
+    const auto newEntity = freeEntities_.back();
+    freeEntities_.pop_back();
     AddComponent(
-        static_cast<Entity>(newEntity), 
+        newEntity,
         static_cast<EntityMask>(ComponentType::EMPTY));
-    return static_cast<Entity>(newEntity);
+    return newEntity;
 }
 
 void EntityManager::DestroyEntity(Entity entity)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    RemoveFromComponentLists(entity, entityMasks_[entity]);
     entityMasks_[entity] = INVALID_ENTITY_MASK;
+    freeEntities_.push_back(entity);
 }
 
 void EntityManager::AddComponent(Entity entity, EntityMask mask)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    AddToComponentLists(entity, mask & ~entityMasks_[entity]);
     entityMasks_[entity] |= mask;
 }
 
 void EntityManager::RemoveComponent(Entity entity, EntityMask mask)
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
+    RemoveFromComponentLists(entity, mask & entityMasks_[entity]);
     entityMasks_[entity] &= ~mask;
 
 }
@@ -71,6 +126,122 @@ std::size_t EntityManager::GetEntitiesSize() const
     return entityMasks_.size();
 }
 
+const std::vector<EntityMask>& EntityManager::GetAllEntityMasks() const
+{
+    return entityMasks_;
+}
+
+void EntityManager::CopyAllEntityMasks(const std::vector<EntityMask>& entityMasks)
+{
+    entityMasks_ = entityMasks;
+    for (auto& entities : componentEntities_)
+    {
+        entities.clear();
+    }
+    freeEntities_.clear();
+    for (Entity entity = 0; entity < entityMasks_.size(); entity++)
+    {
+        for (auto mask = entityMasks_[entity]; mask != 0; mask &= mask - 1)
+        {
+            componentEntities_[std::countr_zero(mask)].push_back(entity);
+        }
+    }
+    for (auto entity = static_cast<Entity>(entityMasks_.size()); entity > 0; entity--)
+    {
+        if (entityMasks_[entity - 1] == INVALID_ENTITY_MASK)
+        {
+            freeEntities_.push_back(entity - 1);
+        }
+    }
+}
+
+void EntityManager::SaveEntities(SnapshotArena& arena) const
+{
+    arena.WriteVector(entityMasks_);
+    arena.WriteVector(freeEntities_);
+    for (const auto& entities : componentEntities_)
+    {
+        arena.WriteVector(entities);
+    }
+}
+
+void EntityManager::RestoreEntities(SnapshotArena& arena)
+{
+    arena.ReadVector(entityMasks_);
+    arena.ReadVector(freeEntities_);
+    for (auto& entities : componentEntities_)
+    {
+        arena.ReadVector(entities);
+    }
+}
+
+std::size_t EntityManager::GetEntityCount() const
+{
+    //Every existing entity has the EMPTY component
+    return GetEntityCount(static_cast<EntityMask>(ComponentType::EMPTY));
+}
+
+std::size_t EntityManager::GetEntityCount(EntityMask component) const
+{
+    gpr_assert(std::has_single_bit(component), "GetEntityCount needs a single component bit");
+    return componentEntities_[std::countr_zero(component)].size();
+}
+
+EntityView EntityManager::View(EntityMask includeMask, EntityMask excludeMask) const
+{
+    gpr_assert(includeMask != INVALID_ENTITY_MASK, "View needs at least one included component");
+    //Walk the list of the rarest included component
+    const std::vector<Entity>* entities = &componentEntities_[std::countr_zero(includeMask)];
+    for (auto mask = includeMask; mask != 0; mask &= mask - 1)
+    {
+        const auto& componentEntities = componentEntities_[std::countr_zero(mask)];
+        if (componentEntities.size() < entities->size())
+        {
+            entities = &componentEntities;
+        }
+    }
+    return { *entities, entityMasks_, includeMask, excludeMask };
+}
+
+void EntityManager::AddToComponentLists(Entity entity, EntityMask mask)
+{
+    for (; mask != 0; mask &= mask - 1)
+    {
+        auto& entities = componentEntities_[std::countr_zero(mask)];
+        //New entities are most of the time the last ones
+        if (entities.empty() || entities.back() < entity)
+        {
+            entities.push_back(entity);
+            continue;
+        }
+        entities.insert(std::lower_bound(entities.begin(), entities.end(), entity), entity);
+    }
+}
+
+void EntityManager::RemoveFromComponentLists(Entity entity, EntityMask mask)
+{
+    for (; mask != 0; mask &= mask - 1)
+    {
+        auto& entities = componentEntities_[std::countr_zero(mask)];
+        const auto it = std::lower_bound(entities.begin(), entities.end(), entity);
+        if (it != entities.end() && *it == entity)
+        {
+            entities.erase(it);
+        }
+    }
+}
+
+void EntityManager::Grow(std::size_t newSize)
+{
+    const auto oldSize = entityMasks_.size();
+    entityMasks_.resize(newSize, INVALID_ENTITY_MASK);
+    //The free-list is empty when growing, the lowest new entity needs to be at its back
+    for (auto entity = static_cast<Entity>(newSize); entity > oldSize; entity--)
+    {
+        freeEntities_.push_back(entity - 1);
+    }
+}
+
 bool EntityManager::HasComponent(Entity entity, EntityMask mask) const
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
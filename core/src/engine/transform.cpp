@@ -21,17 +21,17 @@ Vec2f TransformManager::GetPosition(Entity entity) const
     return positionManager_.GetComponent(entity);
 }
 
-const std::vector<Vec2f>& TransformManager::GetAllPositions() const
+const ComponentVector<Vec2f>& TransformManager::GetAllPositions() const
 {
     return positionManager_.GetAllComponents();
 }
 
-const std::vector<Vec2f>& TransformManager::GetAllScales() const
+const ComponentVector<Vec2f>& TransformManager::GetAllScales() const
 {
     return scaleManager_.GetAllComponents();
 }
 
-const std::vector<Degree>& TransformManager::GetAllRotations() const
+const ComponentVector<Degree>& TransformManager::GetAllRotations() const
 {
     return rotationManager_.GetAllComponents();
 }
@@ -61,6 +61,35 @@ void TransformManager::SetRotation(Entity entity, Degree rotation)
     rotationManager_.SetComponent(entity, rotation);
 }
 
+void TransformManager::CopyAllPositions(const ComponentVector<Vec2f>& positions)
+{
+    positionManager_.CopyAllComponents(positions);
+}
+
+void TransformManager::CopyAllScales(const ComponentVector<Vec2f>& scales)
+{
+    scaleManager_.CopyAllComponents(scales);
+}
+
+void TransformManager::CopyAllRotations(const ComponentVector<Degree>& rotations)
+{
+    rotationManager_.CopyAllComponents(rotations);
+}
+
+void TransformManager::SaveComponents(SnapshotArena& arena) const
+{
+    positionManager_.SaveComponents(arena);
+    scaleManager_.SaveComponents(arena);
+    rotationManager_.SaveComponents(arena);
+}
+
+void TransformManager::RestoreComponents(SnapshotArena& arena)
+{
+    positionManager_.RestoreComponents(arena);
+    scaleManager_.RestoreComponents(arena);
+    rotationManager_.RestoreComponents(arena);
+}
+
 void TransformManager::AddComponent(Entity entity)
 {
     positionManager_.AddComponent(entity);
@@ -1,6 +1,13 @@
 #include <graphics/sprite.h>
 #include <engine/transform.h>
 
+#include <algorithm>
+#include <cmath>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
 namespace core
 {
 void SpriteManager::SetOrigin(Entity entity, sf::Vector2f origin)
@@ -15,30 +22,89 @@ void SpriteManager::SetTexture(Entity entity, const sf::Texture& texture)
 
 void SpriteManager::Draw(sf::RenderTarget& window)
 {
-    for (Entity entity = 0; entity < components_.size(); entity++)
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    for (auto& batch : batches_)
     {
-        if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SPRITE)))
+        batch.second.clear();
+    }
+    for (const auto entity : entityManager_.View<ComponentType::SPRITE>())
+    {
+        UpdateSpriteTransform(entity);
+        if (isBatching_)
+        {
+            AppendToBatch(components_[entity]);
+        }
+        else
         {
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::POSITION)))
-            {
-                const auto position = transformManager_.GetPosition(entity);
-                components_[entity].setPosition(
-                    position.x * pixelPerMeter + center_.x,
-                    windowSize_.y - (position.y * pixelPerMeter + center_.y));
-            }
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SCALE)))
-            {
-                const auto scale = transformManager_.GetScale(entity);
-                components_[entity].setScale(scale);
-            }
-            if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::ROTATION)))
-            {
-                const auto rotation = transformManager_.GetRotation(entity);
-                components_[entity].setRotation(rotation.value());
-            }
             window.draw(components_[entity]);
         }
     }
+    for (const auto& [texture, vertexArray] : batches_)
+    {
+        if (vertexArray.getVertexCount() == 0)
+        {
+            continue;
+        }
+        window.draw(vertexArray, sf::RenderStates(texture));
+    }
+}
+
+void SpriteManager::UpdateSpriteTransform(Entity entity)
+{
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::POSITION)))
+    {
+        const auto position = transformManager_.GetPosition(entity);
+        components_[entity].setPosition(
+            position.x * pixelPerMeter + center_.x,
+            windowSize_.y - (position.y * pixelPerMeter + center_.y));
+    }
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SCALE)))
+    {
+        const auto scale = transformManager_.GetScale(entity);
+        components_[entity].setScale(scale);
+    }
+    if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::ROTATION)))
+    {
+        const auto rotation = transformManager_.GetRotation(entity);
+        components_[entity].setRotation(rotation.value());
+    }
+}
+
+void SpriteManager::AppendToBatch(const sf::Sprite& sprite)
+{
+    const auto* texture = sprite.getTexture();
+    auto batchIt = std::find_if(batches_.begin(), batches_.end(),
+        [texture](const auto& batch) { return batch.first == texture; });
+    if (batchIt == batches_.end())
+    {
+        batches_.emplace_back(texture, sf::VertexArray(sf::Triangles));
+        batchIt = batches_.end() - 1;
+    }
+    auto& vertexArray = batchIt->second;
+
+    const auto& transform = sprite.getTransform();
+    const auto& textureRect = sprite.getTextureRect();
+    const auto color = sprite.getColor();
+    const auto width = static_cast<float>(std::abs(textureRect.width));
+    const auto height = static_cast<float>(std::abs(textureRect.height));
+    const auto left = static_cast<float>(textureRect.left);
+    const auto right = left + static_cast<float>(textureRect.width);
+    const auto top = static_cast<float>(textureRect.top);
+    const auto bottom = top + static_cast<float>(textureRect.height);
+
+    const sf::Vertex topLeft(transform.transformPoint({ 0.0f, 0.0f }), color, { left, top });
+    const sf::Vertex topRight(transform.transformPoint({ width, 0.0f }), color, { right, top });
+    const sf::Vertex bottomRight(transform.transformPoint({ width, height }), color, { right, bottom });
+    const sf::Vertex bottomLeft(transform.transformPoint({ 0.0f, height }), color, { left, bottom });
+    vertexArray.append(topLeft);
+    vertexArray.append(topRight);
+    vertexArray.append(bottomRight);
+    vertexArray.append(topLeft);
+    vertexArray.append(bottomRight);
+    vertexArray.append(bottomLeft);
 }
 
 void SpriteManager::SetColor(Entity entity, sf::Color color)
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "engine/archetype.h"
+#include "maths/vec2.h"
+
+namespace
+{
+constexpr core::Component positionComponent = static_cast<core::Component>(core::ComponentType::POSITION);
+constexpr core::Component rotationComponent = static_cast<core::Component>(core::ComponentType::ROTATION);
+
+core::ArchetypeStorage CreateStorage()
+{
+    core::ArchetypeStorage storage;
+    storage.RegisterComponent<core::Vec2f>(positionComponent);
+    storage.RegisterComponent<float>(rotationComponent);
+    return storage;
+}
+}
+
+TEST(Archetype, AddRemoveComponent)
+{
+    auto storage = CreateStorage();
+    constexpr core::Entity entity = 3;
+    storage.AddComponent(entity, positionComponent);
+    storage.SetComponent(entity, positionComponent, core::Vec2f(1.0f, 2.0f));
+    EXPECT_TRUE(storage.HasComponent(entity, positionComponent));
+    EXPECT_FALSE(storage.HasComponent(entity, rotationComponent));
+
+    //Changing archetype keeps the other components
+    storage.AddComponent(entity, rotationComponent);
+    storage.SetComponent(entity, rotationComponent, 45.0f);
+    EXPECT_EQ(storage.GetArchetypeCount(), 2);
+    EXPECT_FLOAT_EQ(storage.GetComponent<core::Vec2f>(entity, positionComponent).y, 2.0f);
+
+    storage.RemoveComponent(entity, positionComponent);
+    EXPECT_FALSE(storage.HasComponent(entity, positionComponent));
+    EXPECT_FLOAT_EQ(storage.GetComponent<float>(entity, rotationComponent), 45.0f);
+
+    storage.DestroyEntity(entity);
+    EXPECT_FALSE(storage.HasComponent(entity, rotationComponent));
+    EXPECT_EQ(storage.GetEntityCount(), 0);
+}
+
+TEST(Archetype, ForEachSeveralChunks)
+{
+    auto storage = CreateStorage();
+    constexpr core::Entity entityNmb = 2000;
+    for (core::Entity entity = 0; entity < entityNmb; entity++)
+    {
+        storage.AddComponent(entity, positionComponent);
+        storage.SetComponent(entity, positionComponent, core::Vec2f(static_cast<float>(entity), 0.0f));
+        if (entity % 2 == 0)
+        {
+            storage.AddComponent(entity, rotationComponent);
+        }
+    }
+    //Erasing moves the last row of the archetype
+    storage.DestroyEntity(0);
+
+    std::size_t count = 0;
+    storage.ForEach<core::Vec2f, float>({ positionComponent, rotationComponent },
+        [&count](core::Entity entity, core::Vec2f& position, float& rotation)
+        {
+            EXPECT_EQ(entity % 2, 0);
+            EXPECT_FLOAT_EQ(position.x, static_cast<float>(entity));
+            rotation = position.x;
+            count++;
+        });
+    EXPECT_EQ(count, entityNmb / 2 - 1);
+    EXPECT_FLOAT_EQ(storage.GetComponent<float>(entityNmb - 2, rotationComponent), static_cast<float>(entityNmb - 2));
+
+    count = 0;
+    storage.ForEach<core::Vec2f>({ positionComponent },
+        [&count](core::Entity, core::Vec2f&) { count++; });
+    EXPECT_EQ(count, entityNmb - 1);
+}
+
+TEST(Archetype, CopyAll)
+{
+    auto storage = CreateStorage();
+    auto savedStorage = CreateStorage();
+    constexpr core::Entity entity = 0;
+    storage.AddComponent(entity, positionComponent);
+    storage.SetComponent(entity, positionComponent, core::Vec2f(1.0f, 1.0f));
+    savedStorage.CopyAll(storage);
+
+    storage.SetComponent(entity, positionComponent, core::Vec2f(3.0f, 3.0f));
+    storage.AddComponent(1, positionComponent);
+    storage.CopyAll(savedStorage);
+    EXPECT_FLOAT_EQ(storage.GetComponent<core::Vec2f>(entity, positionComponent).x, 1.0f);
+    EXPECT_FALSE(storage.HasComponent(1, positionComponent));
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "utils/atomic_histogram.h"
+
+TEST(AtomicHistogram, Buckets)
+{
+    core::AtomicHistogram<5> histogram;
+    EXPECT_EQ(histogram.GetBucket(0), 0u);
+    EXPECT_EQ(histogram.GetBucket(1), 1u);
+    EXPECT_EQ(histogram.GetBucket(2), 2u);
+    EXPECT_EQ(histogram.GetBucket(3), 2u);
+    EXPECT_EQ(histogram.GetBucket(7), 3u);
+    //The last bucket is unbounded
+    EXPECT_EQ(histogram.GetBucket(8), 4u);
+    EXPECT_EQ(histogram.GetBucket(1000), 4u);
+    EXPECT_EQ(histogram.GetBucketMin(3), 4u);
+
+    histogram.Add(0);
+    histogram.Add(3);
+    histogram.Add(3);
+    histogram.Add(1000);
+    EXPECT_EQ(histogram.GetBucketCount(0), 1u);
+    EXPECT_EQ(histogram.GetBucketCount(2), 2u);
+    EXPECT_EQ(histogram.GetBucketCount(4), 1u);
+    EXPECT_EQ(histogram.GetCount(), 4u);
+    EXPECT_EQ(histogram.GetSum(), 1006u);
+    EXPECT_EQ(histogram.GetMax(), 1000u);
+    EXPECT_DOUBLE_EQ(histogram.GetMean(), 251.5);
+}
+
+TEST(AtomicHistogram, Percentile)
+{
+    core::AtomicHistogram<8> histogram;
+    EXPECT_EQ(histogram.GetPercentile(0.5), 0u);
+    for (int i = 0; i < 90; i++)
+    {
+        histogram.Add(2);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        histogram.Add(200);
+    }
+    EXPECT_EQ(histogram.GetPercentile(0.5), 4u);
+    EXPECT_EQ(histogram.GetPercentile(0.95), 200u);
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+    EXPECT_EQ(histogram.GetMax(), 0u);
+    EXPECT_EQ(histogram.GetBucketCount(2), 0u);
+}
+
+TEST(AtomicHistogram, ConcurrentAdd)
+{
+    constexpr int threadNmb = 4;
+    constexpr int valueNmb = 10000;
+    core::AtomicHistogram<16> histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadNmb; t++)
+    {
+        threads.emplace_back([&histogram, t]
+        {
+            for (int i = 0; i < valueNmb; i++)
+            {
+                histogram.Add(static_cast<std::uint64_t>(t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.GetCount(), static_cast<std::uint64_t>(threadNmb * valueNmb));
+    EXPECT_EQ(histogram.GetSum(), static_cast<std::uint64_t>((1 + 2 + 3 + 4) * valueNmb));
+    EXPECT_EQ(histogram.GetMax(), static_cast<std::uint64_t>(threadNmb));
+}
@@ -77,4 +77,68 @@ TEST(Component, InternalArrayOverflow)
     const auto entity = entityManager.CreateEntity();
     componentManager.AddComponent(entity);
     EXPECT_LT(core::entityInitNmb, componentManager.GetAllComponents().size());
-}
\ No newline at end of file
+}
+class SparseComponentManager : public core::ComponentManager<int, componentType, core::ComponentStorage::SPARSE>
+{
+    using ComponentManager::ComponentManager;
+};
+
+TEST(Component, SparseAddRemoveComponent)
+{
+    constexpr int newValue = 45;
+    core::EntityManager entityManager;
+    SparseComponentManager componentManager(entityManager);
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    componentManager.AddComponent(entity1);
+    componentManager.AddComponent(entity2);
+    componentManager.SetComponent(entity2, newValue);
+    EXPECT_TRUE(entityManager.HasComponent(entity1, componentType));
+    EXPECT_EQ(componentManager.GetAllComponents().GetSize(), 2);
+
+    componentManager.RemoveComponent(entity1);
+    EXPECT_FALSE(entityManager.HasComponent(entity1, componentType));
+    EXPECT_FALSE(componentManager.GetAllComponents().Contains(entity1));
+    EXPECT_EQ(componentManager.GetAllComponents().GetSize(), 1);
+    EXPECT_EQ(componentManager.GetComponent(entity2), newValue);
+}
+
+TEST(Component, SparseCopyAllComponents)
+{
+    constexpr int oldValue1 = 45;
+    constexpr int oldValue2 = 46;
+    constexpr int newValue1 = 43;
+    core::EntityManager entityManager;
+    SparseComponentManager oldComponentManager(entityManager);
+    SparseComponentManager newComponentManager(entityManager);
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    oldComponentManager.AddComponent(entity1);
+    oldComponentManager.SetComponent(entity1, oldValue1);
+    oldComponentManager.AddComponent(entity2);
+    oldComponentManager.SetComponent(entity2, oldValue2);
+    newComponentManager.AddComponent(entity1);
+    newComponentManager.SetComponent(entity1, newValue1);
+
+    oldComponentManager.CopyAllComponents(newComponentManager.GetAllComponents());
+    EXPECT_EQ(oldComponentManager.GetComponent(entity1), newValue1);
+    EXPECT_FALSE(oldComponentManager.GetAllComponents().Contains(entity2));
+    EXPECT_EQ(oldComponentManager.GetAllComponents().GetSize(), 1);
+}
+
+TEST(Component, SparseLargeEntity)
+{
+    core::EntityManager entityManager;
+    SparseComponentManager componentManager(entityManager);
+
+    for (std::size_t i = 0; i < core::entityInitNmb; i++)
+    {
+        entityManager.CreateEntity();
+    }
+    const auto entity = entityManager.CreateEntity();
+    componentManager.AddComponent(entity);
+    EXPECT_EQ(componentManager.GetAllComponents().GetSize(), 1);
+    EXPECT_TRUE(componentManager.GetAllComponents().Contains(entity));
+}
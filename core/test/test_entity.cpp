@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include "engine/component.h"
+#include "utils/snapshot_arena.h"
 
 TEST(Entity, CreateEntity)
 {
@@ -43,4 +44,107 @@ TEST(Entity, EntityComponent)
     entityManager.DestroyEntity(newEntity);
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent));
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent2));
-}
\ No newline at end of file
+}
+TEST(Entity, View)
+{
+    static constexpr core::Component newComponent = 2u;
+    static constexpr core::Component newComponent2 = 4u;
+    core::EntityManager entityManager;
+    std::vector<core::Entity> entities;
+    for (int i = 0; i < 4; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+    }
+    entityManager.AddComponent(entities[3], newComponent | newComponent2);
+    entityManager.AddComponent(entities[0], newComponent);
+    entityManager.AddComponent(entities[2], newComponent2);
+    entityManager.AddComponent(entities[1], newComponent | newComponent2);
+
+    EXPECT_EQ(entityManager.View(newComponent).ToVector(),
+        (std::vector<core::Entity>{ entities[0], entities[1], entities[3] }));
+    EXPECT_EQ((entityManager.View<newComponent, newComponent2>().ToVector()),
+        (std::vector<core::Entity>{ entities[1], entities[3] }));
+    EXPECT_EQ(entityManager.View(newComponent, newComponent2).ToVector(),
+        (std::vector<core::Entity>{ entities[0] }));
+
+    entityManager.RemoveComponent(entities[1], newComponent);
+    entityManager.DestroyEntity(entities[3]);
+    EXPECT_EQ(entityManager.View(newComponent).ToVector(),
+        (std::vector<core::Entity>{ entities[0] }));
+    EXPECT_EQ(entityManager.View(newComponent2).ToVector(),
+        (std::vector<core::Entity>{ entities[1], entities[2] }));
+}
+
+TEST(Entity, ViewAfterCopy)
+{
+    static constexpr core::Component newComponent = 2u;
+    core::EntityManager entityManager;
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    entityManager.AddComponent(entity2, newComponent);
+
+    core::EntityManager otherEntityManager;
+    otherEntityManager.CopyAllEntityMasks(entityManager.GetAllEntityMasks());
+    EXPECT_EQ(otherEntityManager.View(newComponent).ToVector(), std::vector<core::Entity>{ entity2 });
+    EXPECT_EQ(otherEntityManager.View(static_cast<core::EntityMask>(core::ComponentType::EMPTY)).ToVector(),
+        (std::vector<core::Entity>{ entity1, entity2 }));
+}
+
+TEST(Entity, CreateEntityReusesDestroyed)
+{
+    core::EntityManager entityManager(2);
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    EXPECT_EQ(entity1, 0);
+    EXPECT_EQ(entity2, 1);
+    const auto entity3 = entityManager.CreateEntity();
+    EXPECT_EQ(entity3, 2);
+    EXPECT_GT(entityManager.GetEntitiesSize(), 2);
+
+    entityManager.DestroyEntity(entity2);
+    entityManager.DestroyEntity(entity2);
+    EXPECT_EQ(entityManager.CreateEntity(), entity2);
+    EXPECT_NE(entityManager.CreateEntity(), entity2);
+}
+
+TEST(Entity, SaveRestoreEntities)
+{
+    static constexpr core::Component newComponent = 2u;
+    core::EntityManager entityManager;
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    entityManager.AddComponent(entity2, newComponent);
+
+    core::SnapshotArena arena;
+    entityManager.SaveEntities(arena);
+    const auto entity3 = entityManager.CreateEntity();
+    entityManager.DestroyEntity(entity2);
+    entityManager.AddComponent(entity3, newComponent);
+    entityManager.AddComponent(entity1, newComponent);
+
+    arena.Rewind();
+    entityManager.RestoreEntities(arena);
+    EXPECT_TRUE(entityManager.HasComponent(entity2, newComponent));
+    EXPECT_FALSE(entityManager.HasComponent(entity1, newComponent));
+    EXPECT_EQ(entityManager.View(newComponent).ToVector(), std::vector<core::Entity>{ entity2 });
+    //The same entity is created again after the restore
+    EXPECT_EQ(entityManager.CreateEntity(), entity3);
+}
+
+TEST(Entity, GetEntityCount)
+{
+    static constexpr core::Component newComponent = 2u;
+    core::EntityManager entityManager;
+    EXPECT_EQ(entityManager.GetEntityCount(), 0u);
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    entityManager.AddComponent(entity2, newComponent);
+    EXPECT_EQ(entityManager.GetEntityCount(), 2u);
+    EXPECT_EQ(entityManager.GetEntityCount(newComponent), 1u);
+
+    entityManager.DestroyEntity(entity2);
+    EXPECT_EQ(entityManager.GetEntityCount(), 1u);
+    EXPECT_EQ(entityManager.GetEntityCount(newComponent), 0u);
+    entityManager.DestroyEntity(entity1);
+    EXPECT_EQ(entityManager.GetEntityCount(), 0u);
+}
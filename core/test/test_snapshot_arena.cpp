@@ -0,0 +1,156 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "engine/component.h"
+#include "engine/entity.h"
+#include "utils/snapshot_arena.h"
+
+namespace
+{
+constexpr core::EntityMask arenaComponentType = 2u;
+
+class DenseComponentManager : public core::ComponentManager<int, arenaComponentType>
+{
+    using ComponentManager::ComponentManager;
+};
+
+class SparseComponentManager : public core::ComponentManager<int, arenaComponentType, core::ComponentStorage::SPARSE>
+{
+    using ComponentManager::ComponentManager;
+};
+}
+
+TEST(SnapshotArena, WriteRead)
+{
+    core::SnapshotArena arena;
+    const std::vector<float> values{ 1.0f, 2.0f, 3.0f };
+    arena.Write(42);
+    arena.WriteVector(values);
+    arena.Write(7.5);
+    EXPECT_EQ(arena.GetSize(), sizeof(int) + sizeof(std::size_t) + values.size() * sizeof(float) + sizeof(double));
+
+    int intValue = 0;
+    std::vector<float> readValues;
+    double doubleValue = 0.0;
+    arena.Read(intValue);
+    arena.ReadVector(readValues);
+    arena.Read(doubleValue);
+    EXPECT_EQ(intValue, 42);
+    EXPECT_EQ(readValues, values);
+    EXPECT_EQ(doubleValue, 7.5);
+    EXPECT_TRUE(arena.IsAtEnd());
+
+    arena.Rewind();
+    arena.Read(intValue);
+    EXPECT_EQ(intValue, 42);
+}
+
+TEST(SnapshotArena, CopyBytes)
+{
+    core::SnapshotArena arena;
+    arena.Write(42);
+    arena.Write(7.5);
+    const std::vector<std::byte> bytes(arena.GetData(), arena.GetData() + arena.GetSize());
+
+    core::SnapshotArena copiedArena;
+    copiedArena.CopyBytes(bytes.data(), bytes.size());
+    int intValue = 0;
+    double doubleValue = 0.0;
+    copiedArena.Read(intValue);
+    copiedArena.Read(doubleValue);
+    EXPECT_EQ(intValue, 42);
+    EXPECT_EQ(doubleValue, 7.5);
+    EXPECT_TRUE(copiedArena.IsAtEnd());
+}
+
+TEST(SnapshotArena, ClearKeepsMemory)
+{
+    core::SnapshotArena arena;
+    const std::vector<int> values(100, 3);
+    arena.WriteVector(values);
+    const auto* data = arena.GetData();
+    arena.Clear();
+    EXPECT_EQ(arena.GetSize(), 0);
+    arena.WriteVector(values);
+    EXPECT_EQ(arena.GetData(), data);
+}
+
+TEST(SnapshotArena, DenseComponents)
+{
+    core::EntityManager entityManager;
+    DenseComponentManager componentManager(entityManager);
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    componentManager.AddComponent(entity1);
+    componentManager.SetComponent(entity1, 1);
+    componentManager.AddComponent(entity2);
+    componentManager.SetComponent(entity2, 2);
+
+    core::SnapshotArena arena;
+    componentManager.SaveComponents(arena);
+    componentManager.SetComponent(entity1, 10);
+    componentManager.SetComponent(entity2, 20);
+    componentManager.RestoreComponents(arena);
+    EXPECT_EQ(componentManager.GetComponent(entity1), 1);
+    EXPECT_EQ(componentManager.GetComponent(entity2), 2);
+    EXPECT_TRUE(arena.IsAtEnd());
+}
+
+TEST(SnapshotArena, SparseComponents)
+{
+    core::EntityManager entityManager;
+    SparseComponentManager componentManager(entityManager);
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    componentManager.AddComponent(entity1);
+    componentManager.SetComponent(entity1, 1);
+
+    core::SnapshotArena arena;
+    componentManager.SaveComponents(arena);
+    componentManager.AddComponent(entity2);
+    componentManager.SetComponent(entity2, 2);
+    componentManager.SetComponent(entity1, 10);
+    componentManager.RestoreComponents(arena);
+    EXPECT_EQ(componentManager.GetComponent(entity1), 1);
+    EXPECT_FALSE(componentManager.GetAllComponents().Contains(entity2));
+    EXPECT_EQ(componentManager.GetAllComponents().GetSize(), 1);
+}
+
+TEST(SnapshotArena, ReadPastEnd)
+{
+    core::SnapshotArena arena;
+    arena.Write(42);
+    std::int64_t longValue = 7;
+    int intValue = 0;
+    EXPECT_FALSE(arena.Read(longValue));
+    EXPECT_EQ(longValue, 7);
+    EXPECT_TRUE(arena.HasReadError());
+    //The next reads fail until the arena is rewound, even if there is enough data left for them
+    EXPECT_FALSE(arena.Read(intValue));
+    arena.Rewind();
+    EXPECT_FALSE(arena.HasReadError());
+    EXPECT_TRUE(arena.Read(intValue));
+    EXPECT_EQ(intValue, 42);
+}
+
+TEST(SnapshotArena, ReadVectorCorruptedSize)
+{
+    core::SnapshotArena arena;
+    const std::vector<int> values{ 1, 2, 3 };
+    arena.WriteVector(values);
+    //Only a part of the values is copied, like a truncated keyframe
+    core::SnapshotArena truncatedArena;
+    truncatedArena.CopyBytes(arena.GetData(), arena.GetSize() - sizeof(int));
+    std::vector<int> readValues{ 4, 5 };
+    EXPECT_FALSE(truncatedArena.ReadVector(readValues));
+    EXPECT_TRUE(readValues.empty());
+    EXPECT_TRUE(truncatedArena.HasReadError());
+
+    core::SnapshotArena corruptedArena;
+    corruptedArena.Write(std::numeric_limits<std::size_t>::max());
+    EXPECT_FALSE(corruptedArena.ReadVector(readValues));
+    EXPECT_TRUE(readValues.empty());
+}
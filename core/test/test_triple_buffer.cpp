@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include "utils/triple_buffer.h"
+
+TEST(TripleBuffer, PublishAcquire)
+{
+    core::TripleBuffer<int> tripleBuffer;
+    EXPECT_FALSE(tripleBuffer.Acquire());
+
+    tripleBuffer.GetWriteBuffer() = 1;
+    tripleBuffer.Publish();
+    EXPECT_TRUE(tripleBuffer.Acquire());
+    EXPECT_EQ(tripleBuffer.GetReadBuffer(), 1);
+    EXPECT_FALSE(tripleBuffer.Acquire());
+    EXPECT_EQ(tripleBuffer.GetReadBuffer(), 1);
+}
+
+TEST(TripleBuffer, LastPublishedWins)
+{
+    core::TripleBuffer<int> tripleBuffer;
+    tripleBuffer.GetWriteBuffer() = 1;
+    tripleBuffer.Publish();
+    tripleBuffer.GetWriteBuffer() = 2;
+    tripleBuffer.Publish();
+
+    EXPECT_TRUE(tripleBuffer.Acquire());
+    EXPECT_EQ(tripleBuffer.GetReadBuffer(), 2);
+
+    //The producer never writes in the buffer read by the consumer
+    tripleBuffer.GetWriteBuffer() = 3;
+    EXPECT_EQ(tripleBuffer.GetReadBuffer(), 2);
+}
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <vector>
+
+#include "engine/component.h"
+#include "game/physics_manager.h"
+
+namespace
+{
+constexpr std::size_t createdEntityNmb = 64;
+
+void BM_CreateEntity(benchmark::State& state)
+{
+    const auto fillNmb = static_cast<std::size_t>(state.range(0));
+    std::optional<core::EntityManager> entityManager;
+    std::vector<core::Entity> entities(createdEntityNmb);
+    for (auto _ : state)
+    {
+        //Every iteration fills a new entity manager out of the measure, so the measured entities are new ones
+        //created at the fill level, and not the last destroyed ones taken back from the free list
+        state.PauseTiming();
+        entityManager.emplace();
+        for (std::size_t i = 0; i < fillNmb; i++)
+        {
+            entityManager->CreateEntity();
+        }
+        state.ResumeTiming();
+        for (auto& entity : entities)
+        {
+            entity = entityManager->CreateEntity();
+        }
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * createdEntityNmb));
+}
+
+template<core::ComponentStorage S>
+void BM_CopyAllComponents(benchmark::State& state)
+{
+    using BodyManager = core::ComponentManager<game::Body, static_cast<core::EntityMask>(core::ComponentType::BODY2D), S>;
+    const auto componentNmb = static_cast<std::size_t>(state.range(0));
+    core::EntityManager entityManager;
+    BodyManager bodyManager(entityManager);
+    BodyManager copyBodyManager(entityManager);
+    //The entities have the component one out of four times, like the bullets among the other entities
+    for (std::size_t i = 0; i < componentNmb * 4; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (i % 4 == 0)
+        {
+            bodyManager.AddComponent(entity);
+        }
+    }
+    for (auto _ : state)
+    {
+        copyBodyManager.CopyAllComponents(bodyManager.GetAllComponents());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * componentNmb));
+}
+}
+
+BENCHMARK(BM_CreateEntity)->ArgName("fill")->Arg(0)->Arg(128)->Arg(1024)->Arg(8192);
+BENCHMARK_TEMPLATE(BM_CopyAllComponents, core::ComponentStorage::DENSE)->ArgName("components")->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_CopyAllComponents, core::ComponentStorage::SPARSE)->ArgName("components")->RangeMultiplier(8)->Range(8, 4096);
@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+
+#include "network/packet_type.h"
+
+namespace
+{
+/**
+ * \brief BM_PacketRoundTrip measures the serialization of a packet by GeneratePacket and its deserialization by GenerateReceivedPacket.
+ */
+template<typename T>
+void BM_PacketRoundTrip(benchmark::State& state)
+{
+    T sendingPacket;
+    if constexpr (std::is_same_v<T, game::PlayerInputPacket>)
+    {
+        sendingPacket.playerNumber = 1;
+        std::iota(sendingPacket.inputs.begin(), sendingPacket.inputs.end(), std::uint8_t{ 0 });
+    }
+    sf::Packet packet;
+    std::size_t byteNmb = 0;
+    for (auto _ : state)
+    {
+        packet.clear();
+        game::GeneratePacket(packet, sendingPacket);
+        byteNmb += packet.getDataSize();
+        auto receivedPacket = game::GenerateReceivedPacket(packet);
+        benchmark::DoNotOptimize(receivedPacket);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(byteNmb));
+}
+}
+
+BENCHMARK_TEMPLATE(BM_PacketRoundTrip, game::PlayerInputPacket);
+BENCHMARK_TEMPLATE(BM_PacketRoundTrip, game::ValidateFramePacket);
+BENCHMARK_TEMPLATE(BM_PacketRoundTrip, game::SpawnPlayerPacket);
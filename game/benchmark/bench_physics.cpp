@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include "game/physics_manager.h"
+
+namespace
+{
+void BM_PhysicsFixedUpdate(benchmark::State& state)
+{
+    const auto bodyNmb = static_cast<std::size_t>(state.range(0));
+    core::EntityManager entityManager;
+    game::PhysicsManager physicsManager(entityManager);
+    //The bodies move on a grid without touching each other, the cost is the integration and the pairwise box tests
+    constexpr std::size_t bodiesPerRow = 32;
+    for (std::size_t i = 0; i < bodyNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        game::Body body;
+        body.position = { static_cast<float>(i % bodiesPerRow), static_cast<float>(i / bodiesPerRow) };
+        body.velocity = { 0.1f, -0.1f };
+        game::Box box;
+        box.extends = core::Vec2f::one() * 0.1f;
+        physicsManager.AddBody(entity);
+        physicsManager.SetBody(entity, body);
+        physicsManager.AddBox(entity);
+        physicsManager.SetBox(entity, box);
+    }
+    for (auto _ : state)
+    {
+        physicsManager.FixedUpdate(sf::seconds(game::fixedPeriod));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * bodyNmb));
+}
+
+void BM_PhysicsCopyAllComponents(benchmark::State& state)
+{
+    const auto bodyNmb = static_cast<std::size_t>(state.range(0));
+    core::EntityManager entityManager;
+    game::PhysicsManager physicsManager(entityManager);
+    game::PhysicsManager copyPhysicsManager(entityManager);
+    for (std::size_t i = 0; i < bodyNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        physicsManager.AddBody(entity);
+        physicsManager.AddBox(entity);
+    }
+    for (auto _ : state)
+    {
+        copyPhysicsManager.CopyAllComponents(physicsManager);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * bodyNmb));
+}
+}
+
+BENCHMARK(BM_PhysicsFixedUpdate)->ArgName("bodies")->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(BM_PhysicsCopyAllComponents)->ArgName("bodies")->RangeMultiplier(4)->Range(4, 1024);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include "game/game_manager.h"
+
+namespace
+{
+/**
+ * \brief RollbackGameManager is a GameManager whose validated world holds two players and bulletNmb bullets,
+ * with the current frame rollbackDepth frames after the validated one.
+ */
+class RollbackGameManager final : public game::GameManager
+{
+public:
+    RollbackGameManager(game::Frame rollbackDepth, std::size_t bulletNmb)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+        {
+            SpawnPlayer(playerNumber, game::spawnPositions[playerNumber] * 3.0f, game::spawnRotations[playerNumber]);
+        }
+        //The bullets stand still on a grid away from the players, so they are all simulated until the end of their period
+        constexpr std::size_t bulletsPerRow = 32;
+        for (std::size_t i = 0; i < bulletNmb; i++)
+        {
+            const core::Vec2f position{
+                static_cast<float>(i % bulletsPerRow) * 0.5f - 8.0f,
+                static_cast<float>(i / bulletsPerRow) * 0.5f + 5.0f };
+            rollbackManager_.SpawnValidatedBullet(static_cast<game::PlayerNumber>(i % game::maxPlayerNmb), position, core::Vec2f::zero());
+        }
+
+        currentFrame_ = rollbackDepth;
+        rollbackManager_.StartNewFrame(rollbackDepth);
+        for (game::Frame frame = 1; frame <= rollbackDepth; frame++)
+        {
+            //The players turn and shoot, so the resimulation also spawns bullets
+            rollbackManager_.SetPlayerInput(0, game::PlayerInputEnum::UP | game::PlayerInputEnum::SHOOT, frame);
+            rollbackManager_.SetPlayerInput(1, game::PlayerInputEnum::LEFT | game::PlayerInputEnum::SHOOT, frame);
+        }
+    }
+    void SimulateToCurrentFrame()
+    {
+        rollbackManager_.SimulateToCurrentFrame();
+    }
+};
+
+void BM_SimulateToCurrentFrame(benchmark::State& state)
+{
+    const auto rollbackDepth = static_cast<game::Frame>(state.range(0));
+    const auto bulletNmb = static_cast<std::size_t>(state.range(1));
+    RollbackGameManager gameManager(rollbackDepth, bulletNmb);
+    for (auto _ : state)
+    {
+        gameManager.SimulateToCurrentFrame();
+        benchmark::ClobberMemory();
+    }
+    state.counters["frames"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * rollbackDepth, benchmark::Counter::kIsRate);
+}
+}
+
+BENCHMARK(BM_SimulateToCurrentFrame)
+    ->ArgNames({ "depth", "bullets" })
+    ->ArgsProduct({ { 1, 8, 32, 128 }, { 0, 16, 128 } })
+    ->Unit(benchmark::kMicrosecond);
@@ -19,6 +19,8 @@ class GameManager;
 /**
  * \brief BulletManager is a ComponentManager that holds all the Bullet in one place.
  * It will automatically destroy the Bullet when remainingTime is over.
+ * Bullets keep the dense storage: the rollback only flags a destroyed bullet with DESTROYED, and its entity is freed
+ * at validation by the EntityManager without removing the Bullet, which a sparse storage would keep packed.
  */
 class BulletManager : public core::ComponentManager<Bullet, static_cast<core::EntityMask>(ComponentType::BULLET)>
 {
@@ -0,0 +1,234 @@
+#pragma once
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "game_globals.h"
+#include "game_manager.h"
+#include "render_interpolator.h"
+#include "render_snapshot.h"
+#include "speculative_simulator.h"
+#include "star_background.h"
+#include "engine/entity.h"
+#include "graphics/graphics.h"
+#include "graphics/sprite.h"
+#include "engine/system.h"
+#include "engine/transform.h"
+#include "network/packet_type.h"
+#include "utils/triple_buffer.h"
+
+namespace game
+{
+class PacketSenderInterface;
+
+/**
+ * \brief InputDelayMode is how the ClientGameManager input delay is chosen.
+ * FIXED keeps the delay given by the application, ADAPTIVE follows the measured round trip time and its variation.
+ */
+enum class InputDelayMode
+{
+    FIXED,
+    ADAPTIVE
+};
+
+/**
+ * \brief ClientGameManager is a class that inherits from GameManager by adding the visual part and specific implementations needed by the clients.
+ * The simulation (FixedUpdate and rollback) can run on its own thread at the fixed period. In both cases, it publishes a RenderSnapshot
+ * that is the only thing the rendering reads, in its own render world (entities, transforms and sprites).
+ * The render world positions and rotations are interpolated between the two last simulated frames.
+ */
+class ClientGameManager final : public GameManager,
+                                public core::DrawInterface, public core::DrawImGuiInterface, public core::SystemInterface
+{
+public:
+    enum State : std::uint32_t
+    {
+        STARTED = 1u << 0u,
+        FINISHED = 1u << 1u,
+    };
+    explicit ClientGameManager(PacketSenderInterface& packetSenderInterface);
+    ~ClientGameManager() override;
+    ClientGameManager(const ClientGameManager&) = delete;
+    ClientGameManager& operator=(const ClientGameManager&) = delete;
+    ClientGameManager(ClientGameManager&&) = delete;
+    ClientGameManager& operator=(ClientGameManager&&) = delete;
+
+    void StartGame(unsigned long long int startingTime);
+    void Begin() override;
+    void Update(sf::Time dt) override;
+    void End() override;
+    void SetWindowSize(sf::Vector2u windowsSize);
+    [[nodiscard]] sf::Vector2u GetWindowSize() const { return windowSize_; }
+    void Draw(sf::RenderTarget& target) override;
+    void SetClientPlayer(PlayerNumber clientPlayer);
+    /**
+     * \brief SpawnPlayer is method that is called when receiving a SpawnPlayerPacket from the server.
+     * \param playerNumber is the player number to be spawned
+     * \param position is where the player character will be spawned
+     * \param rotation is the spawning angle of the player character 
+     */
+    void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Degree rotation) override;
+    void FixedUpdate();
+    void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame) override;
+    /**
+     * \brief SetLocalPlayerInput is a method that hands the input of the client player to the simulation, without locking it.
+     * It is called by the client application when sampling the keyboard, the simulation sets the last sampled input
+     * on the current frame plus the input delay at the start of its next step.
+     * \param playerInput is the new input of the client player
+     */
+    void SetLocalPlayerInput(PlayerInput playerInput);
+    /**
+     * \brief SetInputDelay is a method that changes the number of frames the local inputs are delayed by, it can be called during a match.
+     * A longer delay gives more time to the remote inputs to arrive and so shallower rollbacks, at the cost of input latency.
+     * When the delay shrinks, no new input frame is sent until the current frame catches up, so a sent input never changes.
+     * It needs to be called with the simulation mutex locked.
+     * \param inputDelay is the new delay in frames, clamped to maxInputDelay
+     */
+    void SetInputDelay(Frame inputDelay);
+    [[nodiscard]] Frame GetInputDelay() const { return inputDelay_; }
+    /**
+     * \brief SetFrameAdvantage is a method that is called when receiving a FrameAdvantagePacket from the server.
+     * The fixed period is slightly lengthened when the client is ahead of the others and shortened when it is behind,
+     * so the clients converge to the same frame without a visible jump. It needs to be called with the simulation mutex locked.
+     * \param frameAdvantage is how many frames the client is ahead of the mean of the other clients
+     */
+    void SetFrameAdvantage(float frameAdvantage);
+    /**
+     * \brief GetFixedPeriod is a method that returns the fixedPeriod scaled by the frame advantage correction.
+     */
+    [[nodiscard]] float GetFixedPeriod() const { return fixedPeriod * fixedPeriodScale_; }
+    void DrawImGui() override;
+    void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& physicsStates);
+    [[nodiscard]] PlayerNumber GetPlayerNumber() const { return clientPlayer_; }
+    void WinGame(PlayerNumber winner) override;
+    /**
+     * \brief GetState is a method that returns the simulation state, it should not be called by the rendering when using the simulation thread.
+     */
+    [[nodiscard]] std::uint32_t GetState() const { return state_; }
+    /**
+     * \brief SetSimulationThreaded is a method that chooses if the simulation runs on its own thread. It must be called before Begin.
+     */
+    void SetSimulationThreaded(bool isThreaded) { isSimulationThreaded_ = isThreaded; }
+    /**
+     * \brief SetHeadless is a method that disables everything only needed to draw (textures, fonts, render world), for bots and soak tests.
+     * It must be called before Begin, Draw and DrawImGui should not be called on a headless ClientGameManager.
+     */
+    void SetHeadless(bool isHeadless) { isHeadless_ = isHeadless; }
+    /**
+     * \brief SetSpeculativeBranchCount is a method that enables the speculative simulation of the remote players inputs on spare cores.
+     * It must be called before Begin.
+     * \param branchCount is the number of alternative inputs simulated for each predicted remote player, 0 disables the speculation
+     */
+    void SetSpeculativeBranchCount(std::size_t branchCount) { speculativeBranchCount_ = branchCount; }
+    /**
+     * \brief GetSimulationMutex is a method that returns the mutex protecting the simulated world.
+     * Every access to the simulated world outside of the ClientGameManager (received packets for example) needs to lock it.
+     */
+    [[nodiscard]] std::mutex& GetSimulationMutex() { return simulationMutex_; }
+protected:
+
+    void UpdateCameraView();
+    /**
+     * \brief DrawPhysics is a method that draws the colliders of the last acquired RenderSnapshot for debugging.
+     */
+    void DrawPhysics(sf::RenderTarget& target);
+    /**
+     * \brief DrawRollbackTelemetryImGui is a method that shows the rollback counters of the simulation, without locking it.
+     */
+    void DrawRollbackTelemetryImGui();
+    /**
+     * \brief SimulationLoop is the method run by the simulation thread, it simulates a frame every fixedPeriod.
+     */
+    void SimulationLoop();
+    /**
+     * \brief SimulateToCurrentFrame is a method that runs the rollback to the current frame and publishes the result as a RenderSnapshot.
+     */
+    void SimulateToCurrentFrame();
+    void PublishRenderSnapshot();
+    /**
+     * \brief ApplyLocalPlayerInput is a method that sets the last sampled local input on the current frame plus the input delay,
+     * it is called by the simulation before simulating.
+     */
+    void ApplyLocalPlayerInput();
+    /**
+     * \brief UpdateRenderWorld is a method that mirrors the last acquired RenderSnapshot in the render world.
+     */
+    void UpdateRenderWorld();
+    /**
+     * \brief InterpolateRenderWorld is a method that sets the render world transforms from the RenderInterpolator, it is called every render frame.
+     */
+    void InterpolateRenderWorld();
+    /**
+     * \brief ConfirmPendingValidateFrame is a method that confirms the validated frame received ahead of the current frame once it is reached.
+     */
+    void ConfirmPendingValidateFrame();
+
+    PacketSenderInterface& packetSenderInterface_;
+    sf::Vector2u windowSize_;
+    sf::View originalView_;
+    sf::View cameraView_;
+    PlayerNumber clientPlayer_ = INVALID_PLAYER;
+    /**
+     * \brief Render world, only accessed by the rendering
+     */
+    core::EntityManager renderEntityManager_;
+    core::TransformManager renderTransformManager_;
+    core::SpriteManager spriteManager_;
+    RenderInterpolator renderInterpolator_;
+    StarBackground starBackground_;
+    float fixedTimer_ = 0.0f;
+    unsigned long long startingTime_ = 0;
+    std::uint32_t state_ = 0;
+    /**
+     * \brief Input delay, the local inputs are set on currentFrame_ + inputDelay_
+     */
+    Frame inputDelay_ = 0;
+    /**
+     * \brief localInput_ is the last input sampled by the application, it is written by the rendering and read by the simulation
+     */
+    std::atomic<PlayerInput> localInput_ = 0u;
+    Frame lastSentInputFrame_ = 0;
+    bool hasSentInput_ = false;
+    /**
+     * \brief With an input delay, the server can validate a frame that is not simulated yet, its confirmation waits for it
+     */
+    Frame pendingValidateFrame_ = 0;
+    std::array<PhysicsState, maxPlayerNmb> pendingPhysicsStates_{};
+    /**
+     * \brief Time synchronization, the fixed period is scaled by fixedPeriodScale_ according to the last frame advantage
+     */
+    float frameAdvantage_ = 0.0f;
+    float fixedPeriodScale_ = 1.0f;
+
+    bool isSimulationThreaded_ = false;
+    bool isHeadless_ = false;
+    std::thread simulationThread_;
+    std::atomic<bool> isSimulationRunning_ = false;
+    /**
+     * \brief simulationException_ is the exception that stopped the simulation thread, it is rethrown by the next Update
+     */
+    std::exception_ptr simulationException_;
+    std::mutex simulationMutex_;
+    core::TripleBuffer<RenderSnapshot> renderSnapshots_;
+    std::size_t speculativeBranchCount_ = 0;
+    SpeculativeSimulator speculativeSimulator_;
+
+    sf::Texture shipTexture_;
+    sf::Texture bulletTexture_;
+    sf::Font font_;
+
+    sf::Text textRenderer_;
+    /**
+     * \brief drawPhysics_ is set by the ImGui and read by the simulation, which only publishes the colliders when it is true
+     */
+    std::atomic<bool> drawPhysics_ = false;
+};
+}
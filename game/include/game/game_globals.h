@@ -3,12 +3,12 @@
  */
 
 #pragma once
-#include <SFML/Graphics/Color.hpp>
+#include <algorithm>
 #include <array>
+#include <cstdint>
 
 #include "engine/component.h"
 #include "engine/entity.h"
-#include "graphics/color.h"
 #include "maths/angle.h"
 #include "maths/vec2.h"
 
@@ -31,6 +31,10 @@ constexpr auto INVALID_PLAYER = std::numeric_limits<PlayerNumber>::max();
 enum class ClientId : std::uint16_t {};
 constexpr auto INVALID_CLIENT_ID = ClientId{ 0 };
 using Frame = std::uint32_t;
+/**
+ * \brief PhysicsState is the type of the physics state checksum
+ */
+using PhysicsState = std::uint16_t;
 /**
  * \brief mmaxPlayerNmb is a integer constant that defines the maximum number of player per game
  */
@@ -62,15 +66,30 @@ constexpr std::size_t maxInputNmb = 50;
  * \brief fixedPeriod is the period used in seconds to start a new FixedUpdate method in the game::GameManager
  */
 constexpr float fixedPeriod = 0.02f; //50fps
-
-
-constexpr std::array<core::Color, std::max(4u, maxPlayerNmb)> playerColors
-{
-    core::Color::red(),
-    core::Color::blue(),
-    core::Color::yellow(),
-    core::Color::cyan()
-};
+/**
+ * \brief maxInputDelay is the maximum number of frames the local inputs can be delayed, 120ms at 50fps
+ */
+constexpr Frame maxInputDelay = 6;
+/**
+ * \brief frameAdvantagePeriod is the number of validated frames between two FrameAdvantagePacket sent by the server
+ */
+constexpr Frame frameAdvantagePeriod = 25;
+/**
+ * \brief frameAdvantageSlewRate is the relative change of the client fixed period per frame of advantage
+ */
+constexpr float frameAdvantageSlewRate = 0.01f;
+/**
+ * \brief maxFixedPeriodSlew is the maximum relative change of the client fixed period, so that the game speed change is not noticeable
+ */
+constexpr float maxFixedPeriodSlew = 0.03f;
+/**
+ * \brief minFrameAdvantage is the frame advantage below which the clients are considered in sync and the fixed period is not changed
+ */
+constexpr float minFrameAdvantage = 0.5f;
+/**
+ * \brief telemetryDumpPeriod is the number of validated frames between two logs of the rollback telemetry, one minute at 50 fps
+ */
+constexpr Frame telemetryDumpPeriod = 50u * 60u;
 
 constexpr std::array<core::Vec2f, std::max(4u, maxPlayerNmb)> spawnPositions
 {
@@ -7,8 +7,8 @@
 
 #include <SFML/System/Time.hpp>
 
-#include "graphics/graphics.h"
 #include "utils/action_utility.h"
+#include "utils/snapshot_arena.h"
 
 namespace core
 {
@@ -77,7 +77,7 @@ public:
  * \brief PhysicsManager is a class that holds both BodyManager and BoxManager and manages the physics fixed update.
  * It allows to register OnTriggerInterface to be called when a trigger occcurs.
  */
-class PhysicsManager : public core::DrawInterface
+class PhysicsManager
 {
 public:
     explicit PhysicsManager(core::EntityManager& entityManager);
@@ -95,17 +95,19 @@ public:
      */
     void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface);
     void CopyAllComponents(const PhysicsManager& physicsManager);
-    void Draw(sf::RenderTarget& renderTarget) override;
-    void SetCenter(sf::Vector2f center) { center_ = center; }
-    void SetWindowSize(sf::Vector2f newWindowSize) { windowSize_ = newWindowSize; }
+    /**
+     * \brief SaveComponents is a method that writes the bodies and the boxes in a SnapshotArena.
+     */
+    void SaveComponents(core::SnapshotArena& arena) const;
+    /**
+     * \brief RestoreComponents is a method that reads back the bodies and the boxes written by SaveComponents.
+     */
+    void RestoreComponents(core::SnapshotArena& arena);
 private:
     core::EntityManager& entityManager_;
     BodyManager bodyManager_;
     BoxManager boxManager_;
     core::Action<core::Entity, core::Entity> onTriggerAction_;
-    //Used for debug
-    sf::Vector2f center_{};
-    sf::Vector2f windowSize_{};
 };
 
 }
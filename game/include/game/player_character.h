@@ -22,8 +22,10 @@ class GameManager;
 
 /**
  * \brief PlayerCharacterManager is a ComponentManager that holds all the PlayerCharacter in the game.
+ * There are only maxPlayerNmb player characters, so they are stored in a sparse set and copied in O(maxPlayerNmb) when rollbacking.
  */
-class PlayerCharacterManager : public core::ComponentManager<PlayerCharacter, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)>
+class PlayerCharacterManager : public core::ComponentManager<PlayerCharacter,
+    static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER), core::ComponentStorage::SPARSE>
 {
 public:
     explicit PlayerCharacterManager(core::EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager);
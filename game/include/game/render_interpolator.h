@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+
+#include "game_globals.h"
+#include "render_snapshot.h"
+#include "engine/entity.h"
+#include "maths/angle.h"
+#include "maths/vec2.h"
+
+namespace game
+{
+/**
+ * \brief correctionThreshold is the distance in meters above which a change of predicted position is considered as a rollback correction and smoothed.
+ */
+constexpr float correctionThreshold = 0.1f;
+/**
+ * \brief correctionAngleThreshold is the rotation above which a change of predicted rotation is considered as a rollback correction and smoothed.
+ */
+constexpr core::Degree correctionAngleThreshold = core::Degree(10.0f);
+/**
+ * \brief teleportThreshold is the distance in meters above which a change of position is never interpolated nor smoothed (entity slot reused for example).
+ */
+constexpr float teleportThreshold = 1.0f;
+/**
+ * \brief correctionSmoothingPeriod is the time constant in seconds used to blend out a rollback correction, a few fixed frames.
+ */
+constexpr float correctionSmoothingPeriod = 4.0f * fixedPeriod;
+
+/**
+ * \brief RenderInterpolator is a class that keeps the two last simulated frames received by the rendering
+ * and interpolates positions and rotations between them with the time elapsed since the last one.
+ * Rollback corrections are kept as an offset that is blended out over a few frames instead of popping:
+ * at a correction, the offset is set so that the entity is still drawn where it was, and the interpolation then converges to the corrected path.
+ * A new frame is expected to continue the last uncorrected step of each entity, a larger difference is a correction.
+ * The interpolation lasts the fixed period of the last snapshot, which is scaled by the frame advantage correction.
+ */
+class RenderInterpolator
+{
+public:
+    /**
+     * \brief PushSnapshot is a method called when the rendering acquires a new RenderSnapshot.
+     * A snapshot of a new frame becomes the interpolation target, a snapshot of the same frame corrects the current target.
+     */
+    void PushSnapshot(const RenderSnapshot& snapshot);
+    /**
+     * \brief Update is a method that advances the interpolation timer and blends out the corrections.
+     * \param dt is the render frame delta time in seconds
+     */
+    void Update(float dt);
+    [[nodiscard]] core::Vec2f GetPosition(core::Entity entity) const;
+    [[nodiscard]] core::Degree GetRotation(core::Entity entity) const;
+    /**
+     * \brief GetInterpolationRatio is a method that returns the ratio between the previous (0) and the current (1) frame.
+     */
+    [[nodiscard]] float GetInterpolationRatio() const;
+    void SetEnabled(bool isEnabled) { isEnabled_ = isEnabled; }
+    [[nodiscard]] bool IsEnabled() const { return isEnabled_; }
+private:
+    /**
+     * \brief Resize is a method that sets the internal arrays to the number of entities of the snapshot.
+     * The entities past it are forgotten, so that an entity created there later is not interpolated from a stale one.
+     */
+    void Resize(std::size_t size);
+    /**
+     * \brief InterpolatePosition is a method that returns the drawn position of the entity at the given interpolation ratio, with its offset.
+     */
+    [[nodiscard]] core::Vec2f InterpolatePosition(core::Entity entity, float ratio) const;
+    [[nodiscard]] core::Degree InterpolateRotation(core::Entity entity, float ratio) const;
+    /**
+     * \brief DeltaAngle is a function that returns the shortest rotation going from a to b, between -180 and 180 degrees.
+     */
+    static core::Degree DeltaAngle(core::Degree a, core::Degree b);
+
+    std::vector<core::EntityMask> masks_;
+    std::vector<core::Vec2f> previousPositions_;
+    std::vector<core::Vec2f> currentPositions_;
+    std::vector<core::Vec2f> positionOffsets_;
+    /**
+     * \brief positionSteps_ and rotationSteps_ are the movements between the two last frames that were not corrections, used to extrapolate the next frame
+     */
+    std::vector<core::Vec2f> positionSteps_;
+    std::vector<core::Degree> previousRotations_;
+    std::vector<core::Degree> currentRotations_;
+    std::vector<core::Degree> rotationOffsets_;
+    std::vector<core::Degree> rotationSteps_;
+    Frame currentFrame_ = 0;
+    float timer_ = 0.0f;
+    float fixedPeriod_ = fixedPeriod;
+    bool isEnabled_ = true;
+};
+}
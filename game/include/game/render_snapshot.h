@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+
+#include "game_globals.h"
+#include "engine/entity.h"
+#include "graphics/color.h"
+#include "utils/profiled_allocator.h"
+#include "maths/angle.h"
+#include "maths/vec2.h"
+
+namespace game
+{
+constexpr std::array<core::Color, std::max(4u, maxPlayerNmb)> playerColors
+{
+    core::Color::red(),
+    core::Color::blue(),
+    core::Color::yellow(),
+    core::Color::cyan()
+};
+
+/**
+ * \brief ColliderBox is a box collider of the simulated world, drawn by the physics debug view.
+ */
+struct ColliderBox
+{
+    core::Vec2f position;
+    core::Vec2f extends;
+};
+
+/**
+ * \brief RenderSnapshot is a struct that contains everything the rendering needs from one simulated frame.
+ * It is written by the simulation and published to the rendering, so that drawing never reads the simulated world directly.
+ * Transforms are stored as separate arrays indexed by core::Entity, like the core::TransformManager.
+ */
+struct RenderSnapshot
+{
+    Frame frame = 0;
+    /**
+     * \brief state is the ClientGameManager::State flags at the time of the snapshot
+     */
+    std::uint32_t state = 0;
+    /**
+     * \brief inputDelay is the number of frames the local inputs are delayed by
+     */
+    Frame inputDelay = 0;
+    /**
+     * \brief frameAdvantage is how many frames the client was ahead of the others in the last FrameAdvantagePacket
+     */
+    float frameAdvantage = 0.0f;
+    /**
+     * \brief fixedPeriod is the period of the simulated frames, scaled by the frame advantage correction
+     */
+    float fixedPeriod = game::fixedPeriod;
+    /**
+     * \brief winner is the player who won the match, INVALID_PLAYER while it is not finished or if it was stopped by an error
+     */
+    PlayerNumber winner = INVALID_PLAYER;
+    /**
+     * \brief startingTime is the clock time when the match starts, 0 until the StartGamePacket is received
+     */
+    unsigned long long startingTime = 0;
+    std::vector<core::EntityMask> entityMasks;
+    core::ComponentVector<core::Vec2f> positions;
+    core::ComponentVector<core::Vec2f> scales;
+    core::ComponentVector<core::Degree> rotations;
+    std::vector<core::Color> colors;
+    std::array<core::Entity, maxPlayerNmb> playerEntities{};
+    std::array<short, maxPlayerNmb> playerHealths{};
+    /**
+     * \brief colliders are the box colliders of the simulated world, only filled when the physics debug view is enabled
+     */
+    std::vector<ColliderBox> colliders;
+};
+}
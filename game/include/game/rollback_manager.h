@@ -1,11 +1,16 @@
 #pragma once
+#include <bitset>
+#include <string>
+
 #include "bullet_manager.h"
 #include "game_globals.h"
 #include "physics_manager.h"
 #include "player_character.h"
+#include "rollback_telemetry.h"
+#include "state_history.h"
 #include "engine/entity.h"
 #include "engine/transform.h"
-#include "network/packet_type.h"
+#include "utils/snapshot_arena.h"
 
 
 
@@ -14,19 +19,40 @@ namespace game
 class GameManager;
 
 /**
- * \brief CreatedEntity is a struct that contains information on the newly created entities.
- * It is used by the RollbackManager to destroy newly created entities when going back in time.
+ * \brief PlayerInputs is the input window of every player, indexed by the distance to the current frame.
+ */
+using PlayerInputs = std::array<std::array<PlayerInput, windowBufferSize>, maxPlayerNmb>;
+
+/**
+ * \brief RollbackState is everything needed by another RollbackManager to resimulate the same frames, the validated world and the inputs.
+ */
+struct RollbackState
+{
+    core::SnapshotArena lastValidateWorld;
+    std::array<core::Entity, maxPlayerNmb> playerEntities{};
+    PlayerInputs inputs{};
+    std::array<Frame, maxPlayerNmb> lastReceivedFrame{};
+    Frame lastValidateFrame = 0;
+    Frame currentFrame = 0;
+};
+
+/**
+ * \brief SpeculativeBranch is a world simulated ahead of time from the validated frame up to frame with its own inputs.
+ * It can replace the resimulation of these frames as long as the received inputs are the same.
  */
-struct CreatedEntity
+struct SpeculativeBranch
 {
-    core::Entity entity = core::INVALID_ENTITY;
-    Frame createdFrame = 0;
+    core::SnapshotArena world;
+    PlayerInputs inputs{};
+    Frame lastValidateFrame = 0;
+    Frame frame = 0;
 };
 
 /**
  * \brief RollbackManager is a class that manages all the rollback mechanisms of the game.
- * It contains two copies of the world (PhysicsManager, TransformManager, etc...), the current one and the validated one.
- * When receiving new information, it can reupdate the current copy of the world.
+ * It contains the current world (PhysicsManager, TransformManager, etc...) and a snapshot of the validated one, serialized in one SnapshotArena.
+ * The snapshot includes the entities and their free-list, so a resimulation creates the same entities on every peer.
+ * When receiving new information, it restores the validated snapshot in the current world and resimulates it.
  */
 class RollbackManager final : public OnTriggerInterface
 {
@@ -34,8 +60,9 @@ public:
     explicit RollbackManager(GameManager& gameManager, core::EntityManager& entityManager);
     /**
      * \brief SimulateToCurrentFrame is a method that simulates all players with new inputs, method call only by the clients to update the current state of the visuals
+     * \param branch is an optional speculative branch, if it is valid the simulation starts from its world instead of the validated one
      */
-    void SimulateToCurrentFrame();
+    void SimulateToCurrentFrame(SpeculativeBranch* branch = nullptr);
     /**
      * \brief SetPlayerInput is a method that set the input of a certain player on a certain game frame.
      * It can change an input between the last validated frame and the current frame.
@@ -54,22 +81,66 @@ public:
     void ValidateFrame(Frame newValidateFrame);
     /**
      * \brief ConfirmFrame is a method that confirms the new validate frame by checking the Physics State checksums
-     * It is called by the clients when receiving Confirm Frame packet
+     * It is called by the clients when receiving Confirm Frame packet.
+     * At the first different checksum, the state history is dumped, if a desync dump path was given.
      * \param newValidatedFrame is the new frame that is validated
      * \param serverPhysicsState is the physics state given by the server through a packet
      */
     void ConfirmFrame(Frame newValidatedFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState);
     [[nodiscard]] PhysicsState GetValidatePhysicsState(PlayerNumber playerNumber) const;
+    /**
+     * \brief SaveRollbackState is a method that copies the validated world and the inputs, to resimulate them in another RollbackManager.
+     */
+    void SaveRollbackState(RollbackState& rollbackState) const;
+    /**
+     * \brief LoadRollbackState is a method that replaces the validated world and the inputs by the ones of another RollbackManager.
+     * The current world is only updated by the next simulation.
+     */
+    void LoadRollbackState(const RollbackState& rollbackState);
+    /**
+     * \brief CheckRollbackState is a method that restores the validated world of a rollback state loaded from a file or received
+     * from the network, to check that it is entirely read and that its player entities are players. The current world is left unchanged.
+     * \return false if the validated world is truncated or corrupted
+     */
+    [[nodiscard]] bool CheckRollbackState(const RollbackState& rollbackState);
+    /**
+     * \brief SetPredictedInput is a method that replaces the predicted input of a player, on all the frames after its last received one.
+     */
+    void SetPredictedInput(PlayerNumber playerNumber, PlayerInput playerInput);
+    /**
+     * \brief SaveSpeculativeBranch is a method that saves the current world and the inputs that produced it.
+     */
+    void SaveSpeculativeBranch(SpeculativeBranch& branch) const;
+    /**
+     * \brief IsBranchValid is a method that checks if a speculative branch starts from the last validated frame
+     * and was simulated with the same inputs as the ones received since.
+     */
+    [[nodiscard]] bool IsBranchValid(const SpeculativeBranch& branch) const;
     [[nodiscard]] Frame GetLastValidateFrame() const { return lastValidateFrame_; }
     [[nodiscard]] Frame GetLastReceivedFrame(PlayerNumber playerNumber) const { return lastReceivedFrame_[playerNumber]; }
     [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
+    /**
+     * \brief GetValidateWorld is a method that returns the snapshot of the last validated world, as written by SaveWorld.
+     */
+    [[nodiscard]] const core::SnapshotArena& GetValidateWorld() const { return lastValidateWorld_; }
     [[nodiscard]] const core::TransformManager& GetTransformManager() const { return currentTransformManager_; }
     [[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return currentPlayerManager_; }
-    void SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Degree rotation);
+    [[nodiscard]] const BulletManager& GetBulletManager() const { return currentBulletManager_; }
+    /**
+     * \brief SpawnPlayer is a method that creates the player entity directly in the validated world.
+     * \return the entity of the new player
+     */
+    core::Entity SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Degree rotation);
     void SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity);
+    /**
+     * \brief SpawnValidatedBullet is a method that creates a bullet entity directly in the validated world, like SpawnPlayer.
+     * The bullets of a match are shot in the simulated frames, this one is used to set up a world with many bullets.
+     * \return the entity of the new bullet
+     */
+    core::Entity SpawnValidatedBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity);
     /**
      * \brief DestroyEntity is a method that does not destroy the entity definitely, but puts the DESTROY flag on.
-     * An entity is truly destroyed when the destroy frame is validated.
+     * An entity is truly destroyed when the destroy frame is validated, a predicted destruction is reverted by restoring the validated entities.
      * \param entity is the entity to be "destroyed"
      */
     void DestroyEntity(core::Entity entity);
@@ -81,7 +152,37 @@ public:
     }
 
     PhysicsManager& GetCurrentPhysicsManager() { return currentPhysicsManager_; }
+    /**
+     * \brief GetTelemetry is a method that returns the rollback counters, they can be read and reset from any thread.
+     */
+    [[nodiscard]] const RollbackTelemetry& GetTelemetry() const { return telemetry_; }
+    [[nodiscard]] RollbackTelemetry& GetTelemetry() { return telemetry_; }
+    /**
+     * \brief GetStateHistory is a method that returns the hashed states of the last validated frames.
+     */
+    [[nodiscard]] const StateHistory& GetStateHistory() const { return stateHistory_; }
+    /**
+     * \brief SetDesyncDumpPath is a method that sets the file where ConfirmFrame dumps the state history,
+     * the frame of the desync is appended to it. No dump is written when empty.
+     */
+    void SetDesyncDumpPath(std::string path) { desyncDumpPath_ = std::move(path); }
 private:
+    /**
+     * \brief SaveWorld is a method that serializes the entities and all the rollback component managers of the current world.
+     */
+    void SaveWorld(core::SnapshotArena& arena) const;
+    /**
+     * \brief RestoreWorld is a method that overwrites the current world with a world serialized by SaveWorld.
+     */
+    void RestoreWorld(core::SnapshotArena& arena);
+    /**
+     * \brief SaveValidateWorld is a method that serializes the rollback state of the current world as the last validated world.
+     */
+    void SaveValidateWorld();
+    /**
+     * \brief RestoreValidateWorld is a method that overwrites the rollback state of the current world with the last validated world.
+     */
+    void RestoreValidateWorld();
 
     [[nodiscard]] PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const;
     GameManager& gameManager_;
@@ -94,11 +195,14 @@ private:
     PlayerCharacterManager currentPlayerManager_;
     BulletManager currentBulletManager_;
     /**
-     * Last Validate (confirm frame) Component Managers used for rollback
+     * \brief lastValidateWorld_ is the snapshot of the last validated (confirm frame) world used for rollback.
+     * Its memory is reused by each validation, saving and restoring it does not allocate once the world stops growing.
      */
-    PhysicsManager lastValidatePhysicsManager_;
-    PlayerCharacterManager lastValidatePlayerManager_;
-    BulletManager lastValidateBulletManager_;
+    core::SnapshotArena lastValidateWorld_;
+    /**
+     * \brief lastValidatePlayerBodies_ are the player bodies of the last validated world, used for the physics state checksums.
+     */
+    std::array<Body, maxPlayerNmb> lastValidatePlayerBodies_{};
 
     /**
      * \brief lastValidateFrame_ is the last validated frame from the server side.
@@ -109,16 +213,24 @@ private:
      */
     Frame currentFrame_ = 0;
     /**
-     * \brief testedFrame_ is the current simulated frame used mainly for entity creation and collision.
+     * \brief testedFrame_ is the current simulated frame.
      */
     Frame testedFrame_ = 0; 
 
     std::array<std::uint32_t, maxPlayerNmb> lastReceivedFrame_{};
-    std::array<std::array<PlayerInput, windowBufferSize>, maxPlayerNmb> inputs_{};
+    PlayerInputs inputs_{};
+    /**
+     * \brief receivedInputs_ flags the inputs that were received and not predicted, indexed like inputs_, for the telemetry
+     */
+    std::array<std::bitset<windowBufferSize>, maxPlayerNmb> receivedInputs_{};
+    RollbackTelemetry telemetry_;
+    /**
+     * \brief stateHistory_ are the states of the last validated frames, recorded by ValidateFrame to look for the origin of a desync
+     */
+    StateHistory stateHistory_;
     /**
-     * \brief Array containing all the created entities in the window between the confirm frame and the current frame
-     * to destroy them when rollbacking.
+     * \brief desyncDumpPath_ is cleared once the state history is dumped, so that only the first desync is written
      */
-    std::vector<CreatedEntity> createdEntities_;
+    std::string desyncDumpPath_;
 };
 }
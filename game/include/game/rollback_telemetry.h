@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "game_globals.h"
+#include "utils/atomic_histogram.h"
+
+namespace game
+{
+/**
+ * \brief RollbackTelemetry is a class that records how often and how deep a RollbackManager rolls back.
+ * It is written by the simulation thread and can be read or reset from any other thread without locking it.
+ */
+class RollbackTelemetry
+{
+public:
+    /**
+     * \brief FrameHistogram counts a number of frames, its last bucket starts at 256 frames, beyond windowBufferSize.
+     */
+    using FrameHistogram = core::AtomicHistogram<10>;
+    /**
+     * \brief TimeHistogram counts durations in nanoseconds, its last bucket starts at about half a second.
+     */
+    using TimeHistogram = core::AtomicHistogram<31>;
+
+    /**
+     * \brief AddSimulation is a method that records one call to SimulateToCurrentFrame.
+     * \param resimulatedFrames is the number of frames simulated from the restored world
+     * \param restoreTime is the time spent restoring the validated world or the speculative branch, in nanoseconds
+     * \param simulateTime is the time spent simulating the frames, in nanoseconds
+     */
+    void AddSimulation(Frame resimulatedFrames, std::uint64_t restoreTime, std::uint64_t simulateTime);
+    /**
+     * \brief AddMispredictedInput is a method that records a received input that differs from the one predicted up to the current frame.
+     */
+    void AddMispredictedInput(PlayerNumber playerNumber);
+    /**
+     * \brief AddValidation is a method that records a validation.
+     * \param validationLag is the number of frames between the current frame and the new validated frame
+     */
+    void AddValidation(Frame validationLag);
+    void Reset();
+
+    [[nodiscard]] const FrameHistogram& GetResimulatedFrames() const { return resimulatedFrames_; }
+    [[nodiscard]] const TimeHistogram& GetRestoreTime() const { return restoreTime_; }
+    [[nodiscard]] const TimeHistogram& GetSimulateTime() const { return simulateTime_; }
+    [[nodiscard]] const FrameHistogram& GetValidationLag() const { return validationLag_; }
+    [[nodiscard]] std::uint64_t GetMispredictedInputs(PlayerNumber playerNumber) const
+    {
+        return mispredictedInputs_[playerNumber].load(std::memory_order_relaxed);
+    }
+    /**
+     * \brief ToString is a method that summarizes the telemetry on one line, for the periodic stats dump.
+     */
+    [[nodiscard]] std::string ToString() const;
+private:
+    FrameHistogram resimulatedFrames_;
+    TimeHistogram restoreTime_;
+    TimeHistogram simulateTime_;
+    FrameHistogram validationLag_;
+    std::array<std::atomic<std::uint64_t>, maxPlayerNmb> mispredictedInputs_{};
+};
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "game_globals.h"
+#include "rollback_manager.h"
+
+namespace game
+{
+/**
+ * \brief speculativeInputToggles are the input changes tried by the speculative branches, from the most to the least likely.
+ * Starting or stopping to shoot is the most common change, then turning, then thrusting.
+ */
+constexpr std::array<PlayerInput, 5> speculativeInputToggles
+{
+    PlayerInputEnum::SHOOT,
+    PlayerInputEnum::LEFT,
+    PlayerInputEnum::RIGHT,
+    PlayerInputEnum::UP,
+    PlayerInputEnum::DOWN
+};
+/**
+ * \brief maxSpeculativeBranchNmb is the maximum number of finished branches kept, the oldest ones are dropped first.
+ */
+constexpr std::size_t maxSpeculativeBranchNmb = 16;
+
+/**
+ * \brief SpeculativeSimulator is a class that uses spare cores to simulate ahead the most likely alternative inputs of the remote players.
+ * Each worker thread owns its own world. When the real input of a remote player differs from the prediction (repeating its last input),
+ * the RollbackManager can start from a branch that was simulated with this input instead of resimulating from the validated frame.
+ * All the methods except the destructor need to be called from the simulation thread.
+ */
+class SpeculativeSimulator
+{
+public:
+    SpeculativeSimulator() = default;
+    ~SpeculativeSimulator();
+    SpeculativeSimulator(const SpeculativeSimulator&) = delete;
+    SpeculativeSimulator& operator=(const SpeculativeSimulator&) = delete;
+    SpeculativeSimulator(SpeculativeSimulator&&) = delete;
+    SpeculativeSimulator& operator=(SpeculativeSimulator&&) = delete;
+    /**
+     * \brief Start is a method that starts one worker per branch, as long as there are cores left for the rendering and the simulation.
+     * \param branchCount is the number of alternative inputs simulated for each predicted remote player
+     * \return false if there is no spare core, the speculation is then disabled
+     */
+    bool Start(std::size_t branchCount);
+    void Stop();
+    [[nodiscard]] bool IsRunning() const { return !workers_.empty(); }
+    /**
+     * \brief Speculate is a method that replaces the pending branches by the ones of the new frame,
+     * for every remote player whose input is predicted.
+     * \param rollbackManager is the RollbackManager of the simulation, whose validated world and inputs are copied
+     * \param localPlayer is the player of this client, its inputs are never predicted
+     */
+    void Speculate(const RollbackManager& rollbackManager, PlayerNumber localPlayer);
+    /**
+     * \brief FindBranch is a method that returns the most advanced finished branch that is still valid for rollbackManager.
+     * \return the branch, valid until the next call to Speculate or FindBranch, or nullptr if none matches
+     */
+    [[nodiscard]] SpeculativeBranch* FindBranch(const RollbackManager& rollbackManager);
+    /**
+     * \brief GetAdoptedBranchCount is a method that returns how many simulations started from a speculative branch, it can be called from any thread.
+     */
+    [[nodiscard]] std::size_t GetAdoptedBranchCount() const { return adoptedBranchCount_.load(std::memory_order_relaxed); }
+private:
+    struct Job
+    {
+        std::shared_ptr<const RollbackState> rollbackState;
+        PlayerNumber playerNumber = INVALID_PLAYER;
+        PlayerInput playerInput = 0u;
+    };
+    void WorkerLoop();
+
+    std::size_t branchCount_ = 0;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable jobCondition_;
+    std::vector<Job> jobs_;
+    std::vector<std::unique_ptr<SpeculativeBranch>> branches_;
+    bool isRunning_ = false;
+    std::atomic<std::size_t> adoptedBranchCount_ = 0;
+};
+}
@@ -0,0 +1,156 @@
+/**
+ * \file state_history.h
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game_globals.h"
+#include "engine/entity.h"
+
+namespace core
+{
+class TransformManager;
+}
+
+namespace game
+{
+class PhysicsManager;
+class PlayerCharacterManager;
+class BulletManager;
+
+/**
+ * \brief stateHistorySize is the number of validated frames kept by a StateHistory, 5 seconds at 50 fps
+ */
+constexpr std::size_t stateHistorySize = 5u * 50u;
+constexpr std::array<char, 4> stateHistoryMagic{ 'G', 'P', 'R', 'H' };
+constexpr std::uint16_t stateHistoryVersion = 2;
+
+/**
+ * \brief StateComponent is a component type of the rollback world, each one has its own hash in a FrameState.
+ * ENTITY is the entity mask, the other ones are the component managers saved in the rollback snapshot.
+ */
+enum class StateComponent : std::uint8_t
+{
+    ENTITY = 0u,
+    POSITION,
+    SCALE,
+    ROTATION,
+    BODY,
+    BOX,
+    PLAYER_CHARACTER,
+    BULLET,
+    LENGTH
+};
+constexpr auto stateComponentNmb = static_cast<std::size_t>(StateComponent::LENGTH);
+
+/**
+ * \brief FrameState is the state of one validated frame.
+ * Each component is hashed field by field, not as raw memory, so that the padding bytes of the structs are ignored.
+ * The hash of a component chains the entity number and the fields of every entity having it, in the order of the entity numbers:
+ * the validation frees the destroyed entities after each frame, so every peer gives the same numbers to the same entities.
+ * The values are the fields of every entity, as 32 bits words: the entity, its mask,
+ * then the fields of each of its components in the StateComponent order.
+ */
+struct FrameState
+{
+    Frame frame = 0;
+    std::array<std::uint64_t, stateComponentNmb> hashes{};
+    std::vector<std::uint32_t> values;
+};
+
+/**
+ * \brief StateDivergence is the first difference between two StateHistory.
+ */
+struct StateDivergence
+{
+    Frame frame = 0;
+    /**
+     * \brief isFirstComparedFrame is true if the states already differ on the first frame kept by both histories,
+     * the divergence may have started earlier
+     */
+    bool isFirstComparedFrame = false;
+    StateComponent component = StateComponent::ENTITY;
+    /**
+     * \brief entity1 and entity2 are the differing entity in each history, they are compared by entity number.
+     * INVALID_ENTITY if the entity has no counterpart in this history, or if only the hashes differ.
+     */
+    core::Entity entity1 = core::INVALID_ENTITY;
+    core::Entity entity2 = core::INVALID_ENTITY;
+    /**
+     * \brief field is the index of the first differing field in the component
+     */
+    std::size_t field = 0;
+    /**
+     * \brief value1 and value2 are the field in each history, nothing if the entity has no counterpart in this history
+     */
+    std::optional<std::uint32_t> value1;
+    std::optional<std::uint32_t> value2;
+};
+
+/**
+ * \brief StateHistory is a class that keeps the state of the last stateHistorySize validated frames of a world.
+ * Every peer records it while validating, a dump of the client and one of the server are compared to find where they diverged.
+ * The frames are stored in a ring buffer whose values are reused, recording a frame does not allocate once the world stops growing.
+ */
+class StateHistory
+{
+public:
+    StateHistory();
+    /**
+     * \brief Record is a method that hashes and stores the given world as the state of frame.
+     * The entities flagged as DESTROYED are skipped, as they are freed right after the frame is recorded.
+     * If frame does not follow the last recorded frame, the history is cleared first.
+     */
+    void Record(Frame frame, const core::EntityManager& entityManager, const core::TransformManager& transformManager,
+        const PhysicsManager& physicsManager, const PlayerCharacterManager& playerCharacterManager, const BulletManager& bulletManager);
+    void Clear();
+    [[nodiscard]] std::size_t GetSize() const { return size_; }
+    /**
+     * \brief GetFrameState is a method that returns the recorded frames from the oldest, index 0, to the newest.
+     */
+    [[nodiscard]] const FrameState& GetFrameState(std::size_t index) const;
+    /**
+     * \brief FindFrameState is a method that returns the state of frame, or nullptr if it is not kept.
+     */
+    [[nodiscard]] const FrameState* FindFrameState(Frame frame) const;
+    /**
+     * \brief Dump is a method that writes the recorded frames in a binary file, read back with Load.
+     * \return false if the file could not be written
+     */
+    bool Dump(std::string_view path) const;
+    /**
+     * \brief Load is a method that replaces the recorded frames by the ones of a file written by Dump.
+     * \return false if the file cannot be read or was not written by this version of the game
+     */
+    bool Load(std::string_view path);
+private:
+    std::vector<FrameState> frames_;
+    /**
+     * \brief first_ is the index in frames_ of the oldest recorded frame
+     */
+    std::size_t first_ = 0;
+    std::size_t size_ = 0;
+};
+
+/**
+ * \brief FindDivergence is a function that compares the frames kept by both histories, from the oldest one.
+ * On the first differing frame, the entities of the first differing component are compared by entity number,
+ * and the first field of the first differing entity is returned.
+ * \return the first divergence, or nothing if the common frames are equal
+ */
+std::optional<StateDivergence> FindDivergence(const StateHistory& history1, const StateHistory& history2);
+/**
+ * \brief ComputeStateHash is a function that combines the component hashes of a frame into the 64 bits hash recorded in the match recordings.
+ */
+[[nodiscard]] std::uint64_t ComputeStateHash(const FrameState& frameState);
+[[nodiscard]] std::string_view GetStateComponentName(StateComponent component);
+/**
+ * \brief ToString is a function that describes a divergence on one line, with the names of the component and of the field.
+ */
+[[nodiscard]] std::string ToString(const StateDivergence& divergence);
+}
@@ -1,6 +1,7 @@
 #pragma once
+#include "clock_sync.h"
 #include "packet_type.h"
-#include "game/game_manager.h"
+#include "game/client_game_manager.h"
 #include "graphics/graphics.h"
 
 namespace game
@@ -20,16 +21,58 @@ public:
     {
         gameManager_.SetWindowSize(windowSize);
     }
+    /**
+     * \brief SetSimulationThreaded is a method that chooses if the game simulation runs on its own thread. It must be called before Begin.
+     */
+    void SetSimulationThreaded(bool isThreaded)
+    {
+        gameManager_.SetSimulationThreaded(isThreaded);
+    }
+    /**
+     * \brief SetSpeculativeBranchCount is a method that sets the number of alternative remote inputs simulated on spare cores, 0 disables it.
+     * It must be called before Begin.
+     */
+    void SetSpeculativeBranchCount(std::size_t branchCount)
+    {
+        gameManager_.SetSpeculativeBranchCount(branchCount);
+    }
+    /**
+     * \brief SetHeadless is a method that runs the client without loading or updating anything used for drawing. It must be called before Begin.
+     */
+    void SetHeadless(bool isHeadless)
+    {
+        gameManager_.SetHeadless(isHeadless);
+    }
+    [[nodiscard]] const ClientGameManager& GetGameManager() const { return gameManager_; }
+    /**
+     * \brief SetInputDelayMode is a method that chooses how the local input delay is set, it can be called during a match.
+     * \param inputDelayMode is FIXED to keep fixedInputDelay, or ADAPTIVE to follow the measured round trip time
+     * \param fixedInputDelay is the delay in frames used with FIXED, and the starting delay with ADAPTIVE
+     */
+    void SetInputDelayMode(InputDelayMode inputDelayMode, Frame fixedInputDelay = 0);
 
     /**
      * \brief ReceiveNetPacket is a method called by an app owning a client when receiving a packet.
      * It is the same one for simulated and network client
      * \param packet A non-owning pointer to a packet (you don't need to care about deleting it
+     * It needs to be called with the simulation mutex of the game manager locked.
      */
     virtual void ReceivePacket(const Packet* packet);
 
     void Update(sf::Time dt) override;
 protected:
+    /**
+     * \brief UpdateAdaptiveInputDelay is a method that moves the input delay one frame toward the round trip time plus a jitter margin.
+     */
+    void UpdateAdaptiveInputDelay();
+    /**
+     * \brief DrawInputDelayImGui is a method that draws the input delay settings in the current ImGui window.
+     */
+    void DrawInputDelayImGui();
+    /**
+     * \brief DrawClockSyncImGui is a method that draws the estimated server clock offset and skew in the current ImGui window.
+     */
+    void DrawClockSyncImGui();
 
     ClientGameManager gameManager_;
     ClientId clientId_ = INVALID_CLIENT_ID;
@@ -44,5 +87,16 @@ protected:
     static constexpr float g = 100.0f;
     static constexpr float alpha = 1.0f/8.0f;
     static constexpr float beta = 1.0f/4.0f;
+    /**
+     * \brief clockSync_ estimates the server clock from the pings, the match starts at the same server time on all the clients
+     */
+    ClockSync clockSync_;
+
+    InputDelayMode inputDelayMode_ = InputDelayMode::FIXED;
+    Frame fixedInputDelay_ = 0;
+    /**
+     * \brief inputDelayJitterFactor is the number of RTTVAR added to the SRTT to cover the remote inputs arrival
+     */
+    static constexpr float inputDelayJitterFactor = 2.0f;
 };
 }
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace game
+{
+/**
+ * \brief clockSyncSampleNmb is the number of ping samples kept by the ClockSync, about 10 seconds of pings.
+ */
+constexpr std::size_t clockSyncSampleNmb = 32;
+/**
+ * \brief maxClockSkew is the maximum relative drift accepted between two clocks (100 ppm, the tolerance of common quartz clocks), it bounds the error of a noisy estimation.
+ */
+constexpr double maxClockSkew = 1.0e-4;
+/**
+ * \brief minClockSkewTime is the minimum time in milliseconds between the two samples used to estimate the skew.
+ */
+constexpr long long minClockSkewTime = 2000;
+
+/**
+ * \brief ClockFunction is a function that returns a time in milliseconds.
+ */
+using ClockFunction = long long (*)();
+/**
+ * \brief SetClockFunction is a function that replaces the clock returned by GetClockTime for the whole process,
+ * for example by a simulated clock advanced faster than real time. It needs to be called before starting any client or server.
+ * \param clockFunction is the new clock, nullptr restores the steady clock
+ */
+void SetClockFunction(ClockFunction clockFunction);
+/**
+ * \brief GetClockTime is a function that returns the monotonic clock used for the match timing, in milliseconds.
+ */
+long long GetClockTime();
+
+/**
+ * \brief ClockSync is a class that estimates the offset and skew of the server clock relative to the local clock, NTP style.
+ * Each ping gives a sample: the server time is assumed to be taken half way through the round trip.
+ * Queuing delays only make the round trip longer, so the sample with the minimum round trip time of the window is the
+ * most accurate one and gives the offset. The skew is the slope between the minimum round trip samples of the older and newer halves of the window.
+ */
+class ClockSync
+{
+public:
+    /**
+     * \brief AddSample is a method that adds the measure of a ping and updates the estimation.
+     * \param clientSendTime is the local time when the ping was sent
+     * \param serverTime is the server time when the ping was answered
+     * \param clientReceiveTime is the local time when the answer was received
+     */
+    void AddSample(long long clientSendTime, long long serverTime, long long clientReceiveTime);
+    void Reset();
+    [[nodiscard]] bool HasEstimate() const { return sampleCount_ > 0; }
+    /**
+     * \brief GetOffset is a method that returns the server time minus the local time, in milliseconds, at the given local time.
+     */
+    [[nodiscard]] double GetOffset(long long clientTime) const;
+    /**
+     * \brief GetSkew is a method that returns how many milliseconds the server clock gains per local millisecond.
+     */
+    [[nodiscard]] double GetSkew() const { return skew_; }
+    [[nodiscard]] long long GetMinRtt() const { return minRtt_; }
+    /**
+     * \brief ToLocalTime is a method that converts a server time to the local clock, used to share the match clock between the clients.
+     */
+    [[nodiscard]] long long ToLocalTime(long long serverTime) const;
+    [[nodiscard]] long long ToServerTime(long long clientTime) const;
+private:
+    struct Sample
+    {
+        long long clientTime = 0;
+        long long rtt = 0;
+        double offset = 0.0;
+    };
+    void UpdateEstimate();
+
+    std::array<Sample, clockSyncSampleNmb> samples_{};
+    std::size_t sampleCount_ = 0;
+    std::size_t nextSample_ = 0;
+    long long referenceTime_ = 0;
+    long long minRtt_ = 0;
+    double offset_ = 0.0;
+    double skew_ = 0.0;
+};
+}
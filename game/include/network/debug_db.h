@@ -6,10 +6,12 @@
 
 #include <string_view>
 #include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace game
 {
@@ -22,23 +24,52 @@ struct DbPhysicsState
     Frame validateFrame{};
 };
 
+/**
+ * \brief DbInput is the record of a received input, it is a row of the inputs table.
+ */
+struct DbInput
+{
+    PlayerNumber playerNumber = INVALID_PLAYER;
+    Frame frame = 0;
+    PlayerInput input = 0;
+};
+
+/**
+ * \brief DebugDatabase is a class that stores the received inputs and physics states in a SQLite database.
+ * The game thread only queues typed records, a worker thread writes all the queued records in one transaction
+ * with prepared statements.
+ */
 class DebugDatabase
 {
 public:
+    ~DebugDatabase();
     void Open(std::string_view path);
     void StorePacket(const PlayerInputPacket* inputPacket);
     void StorePhysicsState(const DbPhysicsState& physicsState);
+    /**
+     * \brief Close is a method that writes the remaining records, stops the worker thread and closes the database.
+     */
     void Close();
 private:
     void Loop();
     void CreateTables() const;
-    sqlite3* db = nullptr;
-    std::atomic<bool> isOver_ = false;
+    void PrepareStatements();
+    /**
+     * \brief WriteRecords is a method that writes the records in one transaction, it is called by the worker thread.
+     */
+    void WriteRecords(const std::vector<DbInput>& inputs, const std::vector<DbPhysicsState>& physicsStates) const;
+    bool Execute(const char* command) const;
+
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* insertInput_ = nullptr;
+    sqlite3_stmt* insertPhysicsState_ = nullptr;
+    bool isOver_ = false;
     std::thread t_;
     mutable std::mutex m_;
     std::condition_variable cv_;
-    std::vector<std::string> commands_;
+    std::vector<DbInput> inputs_;
+    std::vector<DbPhysicsState> physicsStates_;
 };
 
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace game
+{
+/**
+ * \brief LinkDirection is the direction of a LinkModel, UPLINK goes from the client to the server.
+ */
+enum class LinkDirection : std::uint8_t
+{
+    UPLINK,
+    DOWNLINK
+};
+
+/**
+ * \brief JitterDistribution is the shape of the random part of the one way delay of a LinkModel.
+ */
+enum class JitterDistribution : std::uint8_t
+{
+    /**
+     * \brief UNIFORM takes the delay in [delay - jitter, delay + jitter]
+     */
+    UNIFORM,
+    /**
+     * \brief NORMAL takes the delay from a normal distribution of mean delay and standard deviation jitter, clamped at zero
+     */
+    NORMAL,
+    /**
+     * \brief EXPONENTIAL adds an exponential delay of mean jitter to delay, giving the long tail of a congested link
+     */
+    EXPONENTIAL
+};
+
+/**
+ * \brief LinkConfig is the setup of one direction of a simulated link, times are in seconds.
+ */
+struct LinkConfig
+{
+    float delay = 0.25f;
+    float jitter = 0.1f;
+    JitterDistribution jitterDistribution = JitterDistribution::UNIFORM;
+    /**
+     * \brief Gilbert-Elliott burst loss: the link switches between a good and a bad state, each with its own loss probability.
+     * With goodToBad at zero, the loss is independent for every packet with probability lossGood.
+     */
+    float lossGood = 0.0f;
+    float lossBad = 0.0f;
+    float goodToBad = 0.0f;
+    float badToGood = 1.0f;
+    /**
+     * \brief duplicateRate is the probability of delivering an unreliable packet twice, each copy with its own delay
+     */
+    float duplicateRate = 0.0f;
+    /**
+     * \brief reorderRate is the probability of holding back an unreliable packet by reorderDelay, letting the next packets overtake it
+     */
+    float reorderRate = 0.0f;
+    float reorderDelay = 0.05f;
+    /**
+     * \brief bandwidth in bytes per second, the packets are serialized one after the other on the link. Zero is unlimited.
+     */
+    float bandwidth = 0.0f;
+};
+
+/**
+ * \brief Transmission is the result of sending one packet on a LinkModel: no copy if lost, two if duplicated.
+ */
+struct Transmission
+{
+    std::size_t copyNmb = 0;
+    std::array<double, 2> deliveryTimes{};
+};
+
+/**
+ * \brief LinkModel is a class that simulates one direction of the link between a client and the server.
+ * Every link has its own random engine, so the packets of one direction or one client do not change the fate of the others,
+ * and a simulated match is reproduced exactly from its seed.
+ */
+class LinkModel
+{
+public:
+    /**
+     * \brief SetSeed is a method that seeds the link and resets its state.
+     * \param seed is the seed of the match
+     * \param stream identifies the link in the match, so that every link draws a different sequence
+     */
+    void SetSeed(std::uint32_t seed, std::uint32_t stream);
+    void SetConfig(const LinkConfig& config) { config_ = config; }
+    [[nodiscard]] const LinkConfig& GetConfig() const { return config_; }
+    /**
+     * \brief Transmit is a method that decides the fate of a packet sent on the link.
+     * Reliable packets are never lost, duplicated or reordered, they are delivered in order like on a TCP socket.
+     * \param sendTime is the time the packet is sent at, in seconds
+     * \param packetSize is the size of the serialized packet in bytes, used by the bandwidth cap
+     */
+    [[nodiscard]] Transmission Transmit(double sendTime, std::size_t packetSize, bool isReliable);
+    /**
+     * \brief IsInBadState is a method that returns whether the Gilbert-Elliott loss model is in its bad state.
+     */
+    [[nodiscard]] bool IsInBadState() const { return isBadState_; }
+private:
+    [[nodiscard]] float GetRandomDelay();
+    [[nodiscard]] bool IsTrue(float probability);
+    /**
+     * \brief DrawUniform is a method that returns a uniform value in [0, 1) from one draw of the random engine.
+     * The draws are derived from the raw std::mt19937 output, because the results of the standard distributions
+     * depend on the standard library and a seed would not reproduce the same match everywhere.
+     */
+    [[nodiscard]] double DrawUniform();
+
+    LinkConfig config_;
+    std::mt19937 randomEngine_{ std::random_device{}() };
+    bool isBadState_ = false;
+    /**
+     * \brief linkFreeTime_ is the time the last packet finishes being serialized, used by the bandwidth cap
+     */
+    double linkFreeTime_ = 0.0;
+    double lastReliableDeliveryTime_ = 0.0;
+};
+}
@@ -0,0 +1,134 @@
+/**
+ * \file match_recorder.h
+ */
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "game/game_globals.h"
+
+namespace game
+{
+class GameManager;
+class RollbackManager;
+
+/**
+ * \brief matchRecordingMagic starts every match recording file.
+ */
+constexpr std::array<char, 4> matchRecordingMagic{ 'G', 'P', 'R', 'M' };
+constexpr std::uint16_t matchRecordingVersion = 3;
+/**
+ * \brief matchRecordingHeaderSize is the size of the header of a recording: magic, version, player number, keyframe period and fixed period
+ */
+constexpr std::size_t matchRecordingHeaderSize = sizeof(matchRecordingMagic) + sizeof(matchRecordingVersion) +
+    sizeof(std::uint8_t) + sizeof(Frame) + sizeof(float);
+/**
+ * \brief recordingKeyframePeriod is the number of validated frames between two keyframes of a recording, 10 seconds at 50 fps
+ */
+constexpr Frame recordingKeyframePeriod = 50u * 10u;
+/**
+ * \brief recordingFlushSize is the number of bytes of records buffered before they are written to the file
+ */
+constexpr std::size_t recordingFlushSize = 64u * 1024u;
+
+/**
+ * \brief MatchRecordType is the first byte of every record of a match recording.
+ * A recording is a header followed by records, appended in the order of the validated frames:
+ * - the header: magic, version (uint16), player number (uint8), keyframe period (Frame), fixed period (float)
+ * - KEYFRAME: frame, the player entities, the size (uint64) and the bytes of the validated world snapshot
+ * - FRAMES: first frame, frame count (uint32), then for each frame the confirmed inputs of every player
+ *   and the state hash (uint64) of the validated world, given by ComputeStateHash
+ * - END: frame, winner
+ * The values are written in the memory layout of the recording machine.
+ */
+enum class MatchRecordType : std::uint8_t
+{
+    KEYFRAME = 0u,
+    FRAMES,
+    END
+};
+
+/**
+ * \brief MatchRecorder is a class that appends the validated frames of a match to a binary recording.
+ * The records are encoded in a memory buffer by the game thread, a worker thread writes them to the file
+ * once recordingFlushSize bytes are buffered, after each keyframe and when closing.
+ * In stream mode, there is no file nor worker thread: the records stay in the buffer until the owner takes them,
+ * to send them to the spectator relays.
+ */
+class MatchRecorder
+{
+public:
+    MatchRecorder() = default;
+    ~MatchRecorder();
+    MatchRecorder(const MatchRecorder&) = delete;
+    MatchRecorder& operator=(const MatchRecorder&) = delete;
+    MatchRecorder(MatchRecorder&&) = delete;
+    MatchRecorder& operator=(MatchRecorder&&) = delete;
+    /**
+     * \brief Open is a method that creates the recording file, writes its header and starts the worker thread.
+     * \return false if the file could not be created, the records are then ignored
+     */
+    bool Open(std::string_view path);
+    /**
+     * \brief OpenStream is a method that starts a recording in stream mode, its header is the first data of the stream.
+     */
+    void OpenStream();
+    /**
+     * \brief Close is a method that writes the remaining records, stops the worker thread and closes the file.
+     */
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return isOpen_; }
+    /**
+     * \brief RecordKeyframe is a method that records the last validated world of the gameManager.
+     */
+    void RecordKeyframe(const GameManager& gameManager);
+    /**
+     * \brief RecordFrames is a method that records the confirmed inputs and the state hashes from firstFrame to lastFrame.
+     * lastFrame needs to be the last validated frame of the rollbackManager, the frames are taken from its StateHistory.
+     */
+    void RecordFrames(const RollbackManager& rollbackManager, Frame firstFrame, Frame lastFrame);
+    void RecordEnd(Frame frame, PlayerNumber winner);
+    /**
+     * \brief GetStreamData is a method that returns the records of a stream mode recording not yet cleared.
+     */
+    [[nodiscard]] const std::vector<std::byte>& GetStreamData() const { return buffer_; }
+    void ClearStreamData() { buffer_.clear(); }
+private:
+    void WriteHeader();
+    template<typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Records are copied as raw memory");
+        WriteBytes(&value, sizeof(T));
+    }
+    void WriteBytes(const void* data, std::size_t size);
+    /**
+     * \brief EndRecord is a method that wakes up the worker thread if enough bytes are buffered, or if isFlushed is true.
+     */
+    void EndRecord(bool isFlushed);
+    void Loop();
+
+    std::ofstream file_;
+    bool isOpen_ = false;
+    bool isStream_ = false;
+    bool isOver_ = false;
+    std::thread t_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    /**
+     * \brief buffer_ are the encoded records not yet given to the worker thread, only used by the game thread
+     */
+    std::vector<std::byte> buffer_;
+    /**
+     * \brief pendingBuffer_ are the records given to the worker thread, protected by m_
+     */
+    std::vector<std::byte> pendingBuffer_;
+};
+}
@@ -0,0 +1,193 @@
+/**
+ * \file match_replay.h
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "game/game_globals.h"
+#include "network/match_recorder.h"
+
+namespace game
+{
+class GameManager;
+class ReplayGameManager;
+
+/**
+ * \brief RecordedKeyframe is a validated world of a recording, its snapshot bytes are kept in the MatchRecording.
+ */
+struct RecordedKeyframe
+{
+    Frame frame = 0;
+    std::array<core::Entity, maxPlayerNmb> playerEntities{};
+    std::size_t offset = 0;
+    std::size_t size = 0;
+};
+
+/**
+ * \brief RecordedValidation is a frame validated by the server, the last one of a FRAMES record.
+ */
+struct RecordedValidation
+{
+    Frame frame = 0;
+};
+
+/**
+ * \brief RecordInfo is the position of a complete record in the data of a MatchRecording.
+ */
+struct RecordInfo
+{
+    MatchRecordType type = MatchRecordType::KEYFRAME;
+    /**
+     * \brief frame is the frame of a keyframe, the last frame of frames or the frame of the end
+     */
+    Frame frame = 0;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+};
+
+/**
+ * \brief MatchRecording is a class that loads a file written by the MatchRecorder and indexes its records.
+ * It can also be built from a stream of records received from the network: a stream joined during the match
+ * starts with the header and a keyframe, and its frames are only known from this first keyframe.
+ */
+class MatchRecording
+{
+public:
+    /**
+     * \brief Load is a method that reads the whole recording. A truncated last record, from a crashed server, is ignored.
+     * \return false if the file cannot be read or is not a recording of this version of the game
+     */
+    bool Load(std::string_view path);
+    /**
+     * \brief Append is a method that adds the next bytes of a recording and indexes the records they complete.
+     * A record split between two calls is indexed once its last byte is appended.
+     * \return false if the bytes are not a recording of this version of the game, the recording is then not usable
+     */
+    bool Append(const std::byte* data, std::size_t size);
+    void Clear();
+    [[nodiscard]] bool HasHeader() const { return parsedSize_ >= matchRecordingHeaderSize; }
+    /**
+     * \brief GetFirstFrame is a method that returns the frame of the first keyframe, 0 for a whole match.
+     */
+    [[nodiscard]] Frame GetFirstFrame() const { return firstFrame_; }
+    /**
+     * \brief GetLastFrame is a method that returns the last frame with confirmed inputs.
+     */
+    [[nodiscard]] Frame GetLastFrame() const { return firstFrame_ + static_cast<Frame>(inputs_.size()); }
+    /**
+     * \brief GetInputs is a method that returns the confirmed inputs of all the players at frame,
+     * from GetFirstFrame() + 1 to GetLastFrame().
+     */
+    [[nodiscard]] const std::array<PlayerInput, maxPlayerNmb>& GetInputs(Frame frame) const { return inputs_[frame - firstFrame_ - 1]; }
+    /**
+     * \brief GetStateHash is a method that returns the hash of the world validated by the server at frame,
+     * from GetFirstFrame() + 1 to GetLastFrame().
+     */
+    [[nodiscard]] std::uint64_t GetStateHash(Frame frame) const { return stateHashes_[frame - firstFrame_ - 1]; }
+    [[nodiscard]] const std::vector<RecordedKeyframe>& GetKeyframes() const { return keyframes_; }
+    /**
+     * \brief FindKeyframe is a method that returns the last keyframe at or before frame.
+     */
+    [[nodiscard]] const RecordedKeyframe& FindKeyframe(Frame frame) const;
+    [[nodiscard]] const std::byte* GetKeyframeData(const RecordedKeyframe& keyframe) const { return data_.data() + keyframe.offset; }
+    /**
+     * \brief GetValidations is a method that returns the validated frames, sorted by frame.
+     */
+    [[nodiscard]] const std::vector<RecordedValidation>& GetValidations() const { return validations_; }
+    [[nodiscard]] PlayerNumber GetWinner() const { return winner_; }
+    /**
+     * \brief GetRecords is a method that returns the complete records, in the order of the data.
+     */
+    [[nodiscard]] const std::vector<RecordInfo>& GetRecords() const { return records_; }
+    /**
+     * \brief GetData is a method that returns the appended bytes, the header is at the start.
+     */
+    [[nodiscard]] const std::vector<std::byte>& GetData() const { return data_; }
+    /**
+     * \brief GetParsedSize is a method that returns the size of the header and of the complete records.
+     */
+    [[nodiscard]] std::size_t GetParsedSize() const { return parsedSize_; }
+private:
+    std::vector<std::byte> data_;
+    std::size_t parsedSize_ = 0;
+    Frame firstFrame_ = 0;
+    std::vector<std::array<PlayerInput, maxPlayerNmb>> inputs_;
+    std::vector<std::uint64_t> stateHashes_;
+    std::vector<RecordedKeyframe> keyframes_;
+    std::vector<RecordedValidation> validations_;
+    std::vector<RecordInfo> records_;
+    PlayerNumber winner_ = INVALID_PLAYER;
+};
+
+/**
+ * \brief ReplayPlayer is a class that rebuilds the world of a recorded match with the GameManager and RollbackManager logic.
+ * It validates the confirmed inputs at the same frames as the server did and compares the state hash of every validated frame
+ * with the recorded one. Seeking restores the last keyframe before the frame and simulates from there.
+ */
+class ReplayPlayer
+{
+public:
+    explicit ReplayPlayer(const MatchRecording& recording);
+    ~ReplayPlayer();
+    ReplayPlayer(const ReplayPlayer&) = delete;
+    ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+    ReplayPlayer(ReplayPlayer&&) = delete;
+    ReplayPlayer& operator=(ReplayPlayer&&) = delete;
+    /**
+     * \brief Seek is a method that sets the current world to the given frame, clamped to the recorded frames.
+     * Going forward continues from the last validated frame, going backward or past a keyframe restores the keyframe first.
+     */
+    void Seek(Frame frame);
+    /**
+     * \brief Advance is a method that moves the current world frameCount frames forward without restoring any keyframe,
+     * so that every replayed frame is checked against the recorded state hashes.
+     * The frames appended to a streamed recording since the last call are replayed by the next one.
+     */
+    void Advance(Frame frameCount = 1);
+    /**
+     * \brief GetFrame is a method that returns the frame of the current world.
+     */
+    [[nodiscard]] Frame GetFrame() const { return frame_; }
+    [[nodiscard]] const GameManager& GetGameManager() const;
+    /**
+     * \brief GetDesyncNmb is a method that returns the number of replayed frames whose state hash differs from the recorded one.
+     */
+    [[nodiscard]] std::size_t GetDesyncNmb() const { return desyncNmb_; }
+    [[nodiscard]] Frame GetFirstDesyncFrame() const { return firstDesyncFrame_; }
+    /**
+     * \brief IsValid is a method that returns if all the loaded keyframes were valid.
+     * Once a truncated or corrupted keyframe is found, Seek and Advance do nothing.
+     */
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+private:
+    /**
+     * \brief LoadKeyframe is a method that restores the world of the keyframe.
+     * \return false if the keyframe is truncated or corrupted, the world is then left unchanged
+     */
+    bool LoadKeyframe(const RecordedKeyframe& keyframe);
+    /**
+     * \brief SimulateTo is a method that validates the recorded validations up to frame and simulates the remaining frames.
+     */
+    void SimulateTo(Frame frame);
+    /**
+     * \brief Validate is a method that validates the next recorded validation and checks the state hashes of its frames.
+     */
+    void Validate(const RecordedValidation& validation);
+
+    const MatchRecording& recording_;
+    std::unique_ptr<ReplayGameManager> gameManager_;
+    Frame frame_ = 0;
+    /**
+     * \brief nextValidation_ is the index of the first recorded validation after the last validated frame
+     */
+    std::size_t nextValidation_ = 0;
+    std::size_t desyncNmb_ = 0;
+    Frame firstDesyncFrame_ = 0;
+    bool isValid_ = true;
+};
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game/game_globals.h"
+#include "network/link_model.h"
+
+namespace game
+{
+/**
+ * \brief ScriptedInput is an input change of a bot, applied when its client reaches the frame.
+ */
+struct ScriptedInput
+{
+    Frame frame = 0;
+    PlayerNumber playerNumber = INVALID_PLAYER;
+    PlayerInput input = 0u;
+};
+
+/**
+ * \brief MatchConfig is the setup of one headless match.
+ */
+struct MatchConfig
+{
+    /**
+     * \brief seed is used for the SimulationServer links and for the random bots
+     */
+    std::uint32_t seed = 0;
+    /**
+     * \brief Simulated network of every client, uplink goes from the client to the server
+     */
+    LinkConfig uplink{ 0.05f, 0.02f };
+    LinkConfig downlink{ 0.05f, 0.02f };
+    Frame inputDelay = 0;
+    /**
+     * \brief maxFrameNmb stops the match if no player has won, 3 minutes at 50fps by default
+     */
+    Frame maxFrameNmb = 50u * 60u * 3u;
+    /**
+     * \brief randomInputPeriod is the average number of frames a random bot keeps the same input
+     */
+    Frame randomInputPeriod = 10;
+    /**
+     * \brief inputScript are the inputs of the bots, sorted by frame. When empty, the bots play random inputs.
+     */
+    std::vector<ScriptedInput> inputScript;
+    /**
+     * \brief recordPath is the file where the server records the match, no recording when empty
+     */
+    std::string recordPath;
+    /**
+     * \brief dumpDirectory is where the state histories of the server and the clients are dumped at the first desync, no dump when empty
+     */
+    std::string dumpDirectory;
+};
+
+/**
+ * \brief MatchReport is the result of one headless match.
+ */
+struct MatchReport
+{
+    std::uint32_t seed = 0;
+    Frame frameNmb = 0;
+    PlayerNumber winner = INVALID_PLAYER;
+    double wallTime = 0.0;
+    /**
+     * \brief framesPerSecond is the number of match frames simulated per second of wall time
+     */
+    double framesPerSecond = 0.0;
+    Frame maxRollbackDepth = 0;
+    double meanRollbackDepth = 0.0;
+    /**
+     * \brief desyncNmb is the number of validated frames where a client physics state differs from the server one
+     */
+    std::size_t desyncNmb = 0;
+    /**
+     * \brief batchDesyncNmb is the number of server validations whose state, entity numbers included,
+     * differs from the one of the same inputs validated one frame at a time
+     */
+    std::size_t batchDesyncNmb = 0;
+    /**
+     * \brief spectatorDesyncNmb is the number of frames where a spectator replaying the relay stream differs from the server state hashes
+     */
+    std::size_t spectatorDesyncNmb = 0;
+    /**
+     * \brief error is the assertion that stopped the match, or the reason the spectator did not follow the whole match,
+     * empty if the match ran to the end
+     */
+    std::string error;
+};
+
+/**
+ * \brief LoadInputScript is a function that reads a bot input script, one "frame playerNumber input" line per input change.
+ * Empty lines and lines starting with '#' are ignored. The inputs are returned sorted by frame.
+ */
+std::vector<ScriptedInput> LoadInputScript(std::string_view path);
+
+/**
+ * \brief MatchRunner is a class that plays a match between two headless SimulationClient and a SimulationServer
+ * as fast as the CPU allows. The match clock is simulated and advanced by fixedPeriod every step, the network delays
+ * and losses only depend on the seed. Only one MatchRunner can run at a time, as it replaces the process clock.
+ */
+class MatchRunner
+{
+public:
+    explicit MatchRunner(MatchConfig config);
+    MatchReport Run();
+private:
+    MatchConfig config_;
+};
+}
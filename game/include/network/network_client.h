@@ -1,5 +1,7 @@
 #pragma once
 #include "client.h"
+#include <atomic>
+#include <cstdint>
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/Network/UdpSocket.hpp>
 
@@ -50,12 +52,22 @@ private:
 	sf::UdpSocket udpSocket_;
 	sf::TcpSocket tcpSocket_;
 
+	/**
+	 * \brief serverAddress_ is read by the simulation thread when sending the inputs, it is only written with the simulation mutex locked.
+	 * hostInput_ is the address edited in the ImGui, it is copied to serverAddress_ when joining.
+	 */
 	std::string serverAddress_ = "localhost";
+	std::string hostInput_ = "localhost";
 	unsigned short serverTcpPort_ = 12345;
 	unsigned short serverUdpPort_ = 0;
 
 
 	State currentState_ = State::NONE;
+	/**
+	 * \brief sentBytes_ and receivedBytes_ are the totals of the packets data, they are read by the ImGui and Tracy.
+	 */
+	std::atomic<std::uint64_t> sentBytes_ = 0;
+	std::atomic<std::uint64_t> receivedBytes_ = 0;
 
 #ifdef ENABLE_SQLITE
 	DebugDatabase debugDb_;
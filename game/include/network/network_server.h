@@ -1,11 +1,17 @@
 #pragma once
 #include <SFML/Network/IpAddress.hpp>
 #include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/UdpSocket.hpp>
 
-#include "network_client.h"
 #include "server.h"
+#include "spectator_relay.h"
 #include "game/game_globals.h"
 
+#ifdef ENABLE_SQLITE
+#include "network/debug_db.h"
+#endif
+
 namespace game
 {
 /**
@@ -14,7 +20,6 @@ namespace game
 struct ClientInfo
 {
     ClientId clientId = INVALID_CLIENT_ID;
-    unsigned long long timeDifference = 0;
     sf::IpAddress udpRemoteAddress;
     unsigned short udpRemotePort = 0;
 };
@@ -42,6 +47,10 @@ public:
     void End() override;
 
     void SetTcpPort(unsigned short i);
+    /**
+     * \brief SetRelayPort is a method that sets the port the spectator relays connect to, the next free one is used if it is taken.
+     */
+    void SetRelayPort(unsigned short port);
 
     [[nodiscard]] bool IsOpen() const;
     
@@ -56,6 +65,10 @@ private:
     void ReceiveNetPacket(sf::Packet& packet, PacketSocketSource packetSource,
                           sf::IpAddress address = "localhost",
                           unsigned short port = 0);
+    /**
+     * \brief UpdateRelays is a method that gives the new records of the relay stream to the relays and accepts the new ones.
+     */
+    void UpdateRelays();
 
     enum ServerStatus
     {
@@ -72,8 +85,18 @@ private:
 
     unsigned short tcpPort_ = 12345;
     unsigned short udpPort_ = 12345;
+    unsigned short relayPort_ = 12346;
+    /**
+     * \brief relayListener_ sends the relay stream to the spectator relays, without delay, the relays delay it for their spectators
+     */
+    SpectatorListener relayListener_;
     std::uint32_t lastSocketIndex_ = 0;
     std::uint8_t status_ = 0;
+    /**
+     * \brief sentBytes_ and receivedBytes_ are the totals of the packets data, they are plotted in Tracy.
+     */
+    std::uint64_t sentBytes_ = 0;
+    std::uint64_t receivedBytes_ = 0;
 
 #ifdef ENABLE_SQLITE
     DebugDatabase db_;
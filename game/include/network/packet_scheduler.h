@@ -0,0 +1,63 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace game
+{
+/**
+ * \brief PacketScheduler is a class that holds delayed packets in a min-heap keyed by their absolute delivery time.
+ * Push and Pop are O(log n). Packets with the same delivery time are popped in the order they were pushed,
+ * so the reliable packets of a link keep their order.
+ * \tparam PacketPtr is the owning pointer to the packet, std::unique_ptr or std::shared_ptr
+ */
+template<typename PacketPtr>
+class PacketScheduler
+{
+public:
+    void Push(double deliveryTime, PacketPtr packet)
+    {
+        heap_.push_back({ deliveryTime, nextSequence_++, std::move(packet) });
+        std::push_heap(heap_.begin(), heap_.end(), IsLater);
+    }
+    /**
+     * \brief IsDue is a method that returns whether the earliest packet has to be delivered at currentTime.
+     */
+    [[nodiscard]] bool IsDue(double currentTime) const
+    {
+        return !heap_.empty() && heap_.front().deliveryTime <= currentTime;
+    }
+    /**
+     * \brief Pop is a method that removes and returns the earliest packet, the scheduler must not be empty.
+     */
+    PacketPtr Pop()
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), IsLater);
+        auto packet = std::move(heap_.back().packet);
+        heap_.pop_back();
+        return packet;
+    }
+    [[nodiscard]] std::size_t Size() const { return heap_.size(); }
+    [[nodiscard]] bool IsEmpty() const { return heap_.empty(); }
+    void Clear() { heap_.clear(); }
+private:
+    struct DelayPacket
+    {
+        double deliveryTime = 0.0;
+        std::uint64_t sequence = 0;
+        PacketPtr packet = nullptr;
+    };
+    static bool IsLater(const DelayPacket& packet1, const DelayPacket& packet2)
+    {
+        if (packet1.deliveryTime != packet2.deliveryTime)
+        {
+            return packet1.deliveryTime > packet2.deliveryTime;
+        }
+        return packet1.sequence > packet2.sequence;
+    }
+
+    std::vector<DelayPacket> heap_;
+    std::uint64_t nextSequence_ = 0;
+};
+}
@@ -8,6 +8,11 @@
 #include "game/game_globals.h"
 #include <memory>
 #include <chrono>
+#include <new>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
 
 namespace game
 {
@@ -22,14 +27,10 @@ enum class PacketType : std::uint8_t
     JOIN_ACK,
     WIN_GAME,
     PING,
+    FRAME_ADVANTAGE,
     NONE,
 };
 
-/**
- * \brief PhysicsState is the type of the physics state checksum
- */
-using PhysicsState = std::uint16_t;
-
 /**
  * \brief Packet is a interface that defines what a packet with a PacketType.
  */
@@ -37,6 +38,23 @@ struct Packet
 {
     virtual ~Packet() = default;
     PacketType packetType = PacketType::NONE;
+#ifdef TRACY_ENABLE
+    /**
+     * \brief The packets allocated on the heap are reported to Tracy in the memory pool packetMemoryName.
+     */
+    static void* operator new(std::size_t size)
+    {
+        void* ptr = ::operator new(size);
+        TracyAllocN(ptr, size, packetMemoryName);
+        return ptr;
+    }
+    static void operator delete(void* ptr)
+    {
+        TracyFreeN(ptr, packetMemoryName);
+        ::operator delete(ptr);
+    }
+    static constexpr char packetMemoryName[] = "Packets";
+#endif
 };
 
 inline sf::Packet& operator<<(sf::Packet& packetReceived, Packet& packet)
@@ -90,17 +108,16 @@ sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
 struct JoinPacket : TypedPacket<PacketType::JOIN>
 {
     std::array<std::uint8_t, sizeof(ClientId)> clientId{};
-    std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
 };
 
 inline sf::Packet& operator<<(sf::Packet& packet, const JoinPacket& joinPacket)
 {
-    return packet << joinPacket.clientId << joinPacket.startTime;
+    return packet << joinPacket.clientId;
 }
 
 inline sf::Packet& operator>>(sf::Packet& packet, JoinPacket& joinPacket)
 {
-    return packet >> joinPacket.clientId >> joinPacket.startTime;
+    return packet >> joinPacket.clientId;
 }
 
 /**
@@ -150,33 +167,47 @@ inline sf::Packet& operator>>(sf::Packet& packet, SpawnPlayerPacket& spawnPlayer
 /**
  * \brief PlayerInputPacket is a UDP Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
  * and all the previous ones player inputs.
+ * simulationFrame is the frame simulated by the client when sending, currentFrame is ahead of it by the input delay.
  */
 struct PlayerInputPacket : TypedPacket<PacketType::INPUT>
 {
     PlayerNumber playerNumber = INVALID_PLAYER;
     std::array<std::uint8_t, sizeof(Frame)> currentFrame{};
+    std::array<std::uint8_t, sizeof(Frame)> simulationFrame{};
     std::array<std::uint8_t, maxInputNmb> inputs{};
 };
 
 inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
 {
     return packet << playerInputPacket.playerNumber <<
-        playerInputPacket.currentFrame << playerInputPacket.inputs;
+        playerInputPacket.currentFrame << playerInputPacket.simulationFrame << playerInputPacket.inputs;
 }
 
 inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
 {
     return packet >> playerInputPacket.playerNumber >>
-        playerInputPacket.currentFrame >> playerInputPacket.inputs;
+        playerInputPacket.currentFrame >> playerInputPacket.simulationFrame >> playerInputPacket.inputs;
 }
 
 /**
  * \brief StartGamePacket is a TCP Packet send by the server to start a game at a given time.
+ * startTime is in milliseconds of the server clock, the clients convert it with their ClockSync.
  */
 struct StartGamePacket : TypedPacket<PacketType::START_GAME>
 {
+    std::array<std::uint8_t, sizeof(long long)> startTime{};
 };
 
+inline sf::Packet& operator<<(sf::Packet& packet, const StartGamePacket& startGamePacket)
+{
+    return packet << startGamePacket.startTime;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, StartGamePacket& startGamePacket)
+{
+    return packet >> startGamePacket.startTime;
+}
+
 /**
  * \brief ValidateFramePacket is an UDP packet that is sent by the server to validate the last physics state of the world.
  */
@@ -216,21 +247,42 @@ inline sf::Packet& operator>>(sf::Packet& packet, WinGamePacket& winGamePacket)
 
 /**
  * \brief PingPacket is an UDP Packet sent by the client to the server and resend by the server to measure the RTT between the client and the server.
+ * The server adds its own time, so the client can also estimate the offset between their clocks.
  */
 struct PingPacket : TypedPacket<PacketType::PING>
 {
-    std::array<std::uint8_t, sizeof(unsigned long long)> time{};
+    std::array<std::uint8_t, sizeof(long long)> time{};
+    std::array<std::uint8_t, sizeof(long long)> serverTime{};
     std::array<std::uint8_t, sizeof(ClientId)> clientId{};
 };
 
 inline sf::Packet& operator<<(sf::Packet& packet, const PingPacket& pingPacket)
 {
-    return packet << pingPacket.time << pingPacket.clientId;
+    return packet << pingPacket.time << pingPacket.serverTime << pingPacket.clientId;
 }
 
 inline sf::Packet& operator>>(sf::Packet& packet, PingPacket& pingPacket)
 {
-    return packet >> pingPacket.time >> pingPacket.clientId;
+    return packet >> pingPacket.time >> pingPacket.serverTime >> pingPacket.clientId;
+}
+
+/**
+ * \brief FrameAdvantagePacket is an UDP Packet sent regularly by the server with how many frames each client is ahead of the others.
+ * A client ahead (positive advantage) slows down its fixed period a little, a client behind speeds it up.
+ */
+struct FrameAdvantagePacket : TypedPacket<PacketType::FRAME_ADVANTAGE>
+{
+    std::array<std::uint8_t, sizeof(float) * maxPlayerNmb> frameAdvantages{};
+};
+
+inline sf::Packet& operator<<(sf::Packet& packet, const FrameAdvantagePacket& frameAdvantagePacket)
+{
+    return packet << frameAdvantagePacket.frameAdvantages;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, FrameAdvantagePacket& frameAdvantagePacket)
+{
+    return packet >> frameAdvantagePacket.frameAdvantages;
 }
 
 inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
@@ -264,6 +316,8 @@ inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
     }
     case PacketType::START_GAME:
     {
+        const auto& packetTmp = static_cast<StartGamePacket&>(sendingPacket);
+        packet << packetTmp;
         break;
     }
     case PacketType::JOIN_ACK:
@@ -284,6 +338,12 @@ inline void GeneratePacket(sf::Packet& packet, Packet& sendingPacket)
         packet << packetTmp;
         break;
     }
+    case PacketType::FRAME_ADVANTAGE:
+    {
+        const auto& packetTmp = static_cast<FrameAdvantagePacket&>(sendingPacket);
+        packet << packetTmp;
+        break;
+    }
 
     default:
         break;
@@ -328,6 +388,7 @@ inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
     {
         auto startGamePacket = std::make_unique<StartGamePacket>();
         startGamePacket->packetType = packetTmp.packetType;
+        packet >> *startGamePacket;
         return startGamePacket;
     }
     case PacketType::JOIN_ACK:
@@ -351,6 +412,13 @@ inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
         packet >> *pingPacket;
         return pingPacket;
     }
+    case PacketType::FRAME_ADVANTAGE:
+    {
+        auto frameAdvantagePacket = std::make_unique<FrameAdvantagePacket>();
+        frameAdvantagePacket->packetType = packetTmp.packetType;
+        packet >> *frameAdvantagePacket;
+        return frameAdvantagePacket;
+    }
     default:;
     }
     return nullptr;
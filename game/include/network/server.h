@@ -1,6 +1,9 @@
 #pragma once
+#include <cstddef>
 #include <memory>
+#include <vector>
 
+#include "match_recorder.h"
 #include "packet_type.h"
 #include "engine/system.h"
 #include "game/game_globals.h"
@@ -13,6 +16,28 @@ namespace game
  */
 class Server : public PacketSenderInterface, public core::SystemInterface
 {
+public:
+    [[nodiscard]] const GameManager& GetGameManager() const { return gameManager_; }
+    /**
+     * \brief StartRecording is a method that records the validated frames of the match in a binary file, until the match is won.
+     * It needs to be called before the game starts.
+     * \return false if the recording file could not be created
+     */
+    bool StartRecording(std::string_view path);
+    /**
+     * \brief StopRecording is a method that writes the remaining records and closes the recording file.
+     */
+    void StopRecording();
+    /**
+     * \brief OpenRelayStream is a method that starts the stream of the validated frames sent to the spectator relays.
+     * It needs to be called before the game starts.
+     */
+    void OpenRelayStream();
+    /**
+     * \brief GetRelayStreamData is a method that returns the streamed records not taken yet, ClearRelayStreamData takes them.
+     */
+    [[nodiscard]] const std::vector<std::byte>& GetRelayStreamData() const { return relayRecorder_.GetStreamData(); }
+    void ClearRelayStreamData() { relayRecorder_.ClearStreamData(); }
 protected:
 
     virtual void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) = 0;
@@ -21,11 +46,34 @@ protected:
      * \param packet is the received Packet.
      */
     virtual void ReceivePacket(std::unique_ptr<Packet> packet);
+    /**
+     * \brief SendFrameAdvantages is a method that estimates the frame currently simulated by each client
+     * from its last PlayerInputPacket and sends how far each one is ahead of the mean of the others.
+     */
+    void SendFrameAdvantages();
+    /**
+     * \brief RecordKeyframe, RecordFrames and RecordEnd are methods that add a record to the recording file and to the relay stream.
+     */
+    void RecordKeyframe();
+    void RecordFrames(Frame firstFrame, Frame lastFrame);
+    void RecordEnd(Frame frame, PlayerNumber winner);
 
     //Server game manager
     GameManager gameManager_;
     PlayerNumber lastPlayerNumber_ = 0;
     std::array<ClientId, maxPlayerNmb> clientMap_{};
+    /**
+     * \brief Time synchronization, the last simulated frame reported by each client and when it was received
+     */
+    std::array<Frame, maxPlayerNmb> lastSimulationFrames_{};
+    std::array<long long, maxPlayerNmb> lastInputTimes_{};
+    Frame lastFrameAdvantageFrame_ = 0;
+    MatchRecorder recorder_;
+    /**
+     * \brief relayRecorder_ is the stream of the validated frames sent to the spectator relays, only recorded once opened by OpenRelayStream.
+     * Unlike the recording file, it stays open after the match is won so that the relays can receive the end.
+     */
+    MatchRecorder relayRecorder_;
 
 };
 }
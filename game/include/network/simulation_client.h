@@ -31,6 +31,10 @@ public:
     
     void DrawImGui() override;
     void SetPlayerInput(PlayerInput input);
+    /**
+     * \brief Join is a method that sends the JoinPacket to the server, the player is then spawned by the server.
+     */
+    void Join();
     
 private:
     SimulationServer& server_;
@@ -3,23 +3,18 @@
 #include <SFML/System/Time.hpp>
 
 #include "debug_db.h"
+#include "link_model.h"
+#include "packet_scheduler.h"
 #include "server.h"
 #include "graphics/graphics.h"
 
 namespace game
 {
-/**
- * \brief DelayPacket is a struct used by the SimulationServer to delay received Packet.
- */
-struct DelayPacket
-{
-	float currentTime = 0.0f;
-	std::unique_ptr<Packet> packet = nullptr;
-};
 class SimulationClient;
 
 /**
  * \brief SimulationServer is a Server that delays Packet internally before "receiving" them and then sends them back with delay to the SimulationClient.
+ * Every client has its own LinkModel in each direction.
  */
 class SimulationServer final : public Server, public core::DrawImGuiInterface
 {
@@ -29,20 +24,41 @@ public:
 	void Update(sf::Time dt) override;
 	void End() override;
 	void DrawImGui() override;
-	void PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, bool unreliable);
+	void PutPacketInReceiveQueue(const SimulationClient& client, std::unique_ptr<Packet> packet, bool unreliable);
 	void SendReliablePacket(std::unique_ptr<Packet> packet) override;
 	void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+	/**
+	 * \brief SetSeed is a method that seeds every link, so that a simulated match can be replayed.
+	 */
+	void SetSeed(std::uint32_t seed);
+	/**
+	 * \brief SetLinkConfig is a method that sets the configuration of every link in both directions.
+	 */
+	void SetLinkConfig(const LinkConfig& linkConfig);
+	void SetLinkConfig(std::size_t clientIndex, LinkDirection direction, const LinkConfig& linkConfig);
 private:
-	void PutPacketInSendingQueue(std::unique_ptr<Packet> packet);
+	void PutPacketInSendingQueue(std::unique_ptr<Packet> packet, bool unreliable);
 	void ProcessReceivePacket(std::unique_ptr<Packet> packet);
+	[[nodiscard]] std::size_t GetClientIndex(const SimulationClient& client) const;
+	[[nodiscard]] LinkModel& GetLinkModel(std::size_t clientIndex, LinkDirection direction);
 
 	void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
 
-	std::vector<DelayPacket> receivedPackets_;
-	std::vector<DelayPacket> sentPackets_;
+	PacketScheduler<std::unique_ptr<Packet>> receivedPackets_;
+	/**
+	 * \brief sentPackets_ are the packets in flight to each client, a packet sent to every client is shared between them
+	 */
+	std::array<PacketScheduler<std::shared_ptr<const Packet>>, maxPlayerNmb> sentPackets_;
 	std::array<std::unique_ptr<SimulationClient>, maxPlayerNmb>& clients_;
-	float avgDelay_ = 0.25f;
-	float marginDelay_ = 0.1f;
-	float packetLoss_ = 0.0f;
+	std::array<LinkModel, maxPlayerNmb> uplinks_;
+	std::array<LinkModel, maxPlayerNmb> downlinks_;
+	/**
+	 * \brief linkConfig_ is the configuration edited in the ImGui window, applied to every link
+	 */
+	LinkConfig linkConfig_;
+	/**
+	 * \brief currentTime_ is the time since the creation of the server in seconds, the packets are delivered at an absolute time
+	 */
+	double currentTime_ = 0.0;
 };
 }
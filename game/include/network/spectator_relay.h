@@ -0,0 +1,182 @@
+/**
+ * \file spectator_relay.h
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/TcpListener.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+
+#include "engine/system.h"
+#include "network/match_replay.h"
+
+namespace game
+{
+/**
+ * \brief relayReceiveSize is the number of bytes read at once from the upstream of a relay
+ */
+constexpr std::size_t relayReceiveSize = 16u * 1024u;
+
+/**
+ * \brief SpectatorCursor is the position of a spectator in a SpectatorStream.
+ */
+struct SpectatorCursor
+{
+    /**
+     * \brief isJoined is false until the spectator is given a keyframe to start from
+     */
+    bool isJoined = false;
+    /**
+     * \brief headerOffset is the number of header bytes already sent
+     */
+    std::size_t headerOffset = 0;
+    /**
+     * \brief offset is the position in the stream data of the next byte to send, after the header
+     */
+    std::size_t offset = 0;
+};
+
+/**
+ * \brief SpectatorStream is a class that keeps the match recording streamed by the server, as it is received,
+ * and gives each spectator the bytes it can see. A record becomes visible broadcastDelay milliseconds after its arrival.
+ * A spectator joins at the last visible keyframe: it is sent the header, then the visible records from this keyframe,
+ * so that it only ever receives the validated inputs and keyframes, in the same format as a recording file.
+ * The spectators only keep an offset in the shared data, nothing is copied per spectator.
+ */
+class SpectatorStream
+{
+public:
+    explicit SpectatorStream(long long broadcastDelay = 0) : broadcastDelay_(broadcastDelay) {}
+    /**
+     * \brief Append is a method that adds the next bytes of the stream, received at time.
+     * \return false if the bytes are not a recording of this version of the game
+     */
+    bool Append(const std::byte* data, std::size_t size, long long time);
+    /**
+     * \brief Update is a method that makes visible the records received at least broadcastDelay milliseconds before time.
+     */
+    void Update(long long time);
+    /**
+     * \brief GetPendingData is a method that returns the next visible bytes to send to the spectator,
+     * nothing if it is up to date or if no keyframe is visible yet. It joins the spectator at the last visible keyframe.
+     * The bytes are only valid until the next Append.
+     */
+    [[nodiscard]] std::span<const std::byte> GetPendingData(SpectatorCursor& cursor) const;
+    /**
+     * \brief Consume is a method that moves the spectator after the size first bytes returned by GetPendingData.
+     */
+    static void Consume(SpectatorCursor& cursor, std::size_t size);
+    [[nodiscard]] const MatchRecording& GetRecording() const { return recording_; }
+    [[nodiscard]] long long GetBroadcastDelay() const { return broadcastDelay_; }
+    /**
+     * \brief HasHiddenRecords is a method that returns true if some received records are not visible yet.
+     */
+    [[nodiscard]] bool HasHiddenRecords() const { return visibleRecordNmb_ < recordTimes_.size(); }
+private:
+    MatchRecording recording_;
+    /**
+     * \brief recordTimes_ is the arrival time of each record of the recording
+     */
+    std::vector<long long> recordTimes_;
+    long long broadcastDelay_ = 0;
+    std::size_t visibleRecordNmb_ = 0;
+    /**
+     * \brief visibleSize_ is the end of the visible records in the stream data
+     */
+    std::size_t visibleSize_ = 0;
+    /**
+     * \brief joinOffset_ is the position of the last visible keyframe record, valid if hasJoinKeyframe_
+     */
+    std::size_t joinOffset_ = 0;
+    bool hasJoinKeyframe_ = false;
+};
+
+/**
+ * \brief SpectatorListener is a class that accepts spectator connections on a TCP port and sends them a SpectatorStream.
+ * The sockets are not blocking: a spectator whose connection is slow is resumed where it stopped on the next Update,
+ * and a disconnected spectator is dropped.
+ */
+class SpectatorListener
+{
+public:
+    explicit SpectatorListener(long long broadcastDelay = 0) : stream_(broadcastDelay) {}
+    /**
+     * \brief Listen is a method that listens on port, or on the next free port.
+     * \return the port listened on
+     */
+    unsigned short Listen(unsigned short port);
+    bool Append(const std::byte* data, std::size_t size, long long time) { return stream_.Append(data, size, time); }
+    /**
+     * \brief Update is a method that accepts the new spectators and sends the visible bytes to all of them.
+     */
+    void Update(long long time);
+    /**
+     * \brief Flush is a method that sends the visible bytes to all the spectators, waiting for the slow ones. It is called before closing.
+     */
+    void Flush();
+    /**
+     * \brief IsSending is a method that returns true if some spectators have not been sent all the visible bytes yet.
+     */
+    [[nodiscard]] bool IsSending() const { return isSending_; }
+    [[nodiscard]] std::size_t GetSpectatorNmb() const { return spectators_.size(); }
+    [[nodiscard]] const SpectatorStream& GetStream() const { return stream_; }
+private:
+    struct Spectator
+    {
+        sf::TcpSocket socket;
+        SpectatorCursor cursor;
+    };
+    /**
+     * \brief Send is a method that sends the visible bytes to the spectator until its socket is full.
+     * \return false if the spectator is disconnected
+     */
+    bool Send(Spectator& spectator);
+
+    sf::TcpListener listener_;
+    std::vector<std::unique_ptr<Spectator>> spectators_;
+    /**
+     * \brief nextSpectator_ is the spectator given to the next accept
+     */
+    std::unique_ptr<Spectator> nextSpectator_ = std::make_unique<Spectator>();
+    SpectatorStream stream_;
+    bool isSending_ = false;
+};
+
+/**
+ * \brief SpectatorRelay is a process that receives the stream of a match from a server or from another relay
+ * and sends it to its spectators, which can be other relays. Chaining relays in a tree keeps the spectators
+ * off the authoritative server, which only sends its stream to the first relays.
+ */
+class SpectatorRelay final : public core::SystemInterface
+{
+public:
+    explicit SpectatorRelay(long long broadcastDelay = 0) : spectatorListener_(broadcastDelay) {}
+    void SetUpstream(const sf::IpAddress& address, unsigned short port);
+    void SetListenPort(unsigned short port) { listenPort_ = port; }
+    /**
+     * \brief GetListenPort is a method that returns the port the spectators connect to, once begun.
+     */
+    [[nodiscard]] unsigned short GetListenPort() const { return listenPort_; }
+    void Begin() override;
+    void Update(sf::Time dt) override;
+    void End() override;
+    /**
+     * \brief IsOpen is a method that returns true while the upstream is connected or the spectators have not received everything yet.
+     */
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] const SpectatorListener& GetSpectatorListener() const { return spectatorListener_; }
+private:
+    sf::TcpSocket upstreamSocket_;
+    sf::IpAddress upstreamAddress_ = "localhost";
+    unsigned short upstreamPort_ = 12346;
+    unsigned short listenPort_ = 12400;
+    bool isUpstreamConnected_ = false;
+    std::array<std::byte, relayReceiveSize> receiveBuffer_{};
+    SpectatorListener spectatorListener_;
+};
+}
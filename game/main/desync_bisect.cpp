@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "game/state_history.h"
+
+#include <fmt/format.h>
+
+namespace
+{
+void PrintUsage()
+{
+    fmt::print("Usage: desync_bisect DUMP1 DUMP2\n"
+        "Compares two state history dumps, written by a client at a desync or by replay --dump-hashes,\n"
+        "and prints the first diverging frame, entity and field.\n");
+}
+
+void PrintRange(const std::string& path, const game::StateHistory& history)
+{
+    if (history.GetSize() == 0)
+    {
+        fmt::print("{}: no frame\n", path);
+        return;
+    }
+    fmt::print("{}: frames {} to {}\n", path, history.GetFrameState(0).frame, history.GetFrameState(history.GetSize() - 1).frame);
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    const std::string path1 = argv[1];
+    const std::string path2 = argv[2];
+    game::StateHistory history1;
+    game::StateHistory history2;
+    if (!history1.Load(path1) || !history2.Load(path2))
+    {
+        return EXIT_FAILURE;
+    }
+    PrintRange(path1, history1);
+    PrintRange(path2, history2);
+
+    const auto firstCommonFrame = history1.GetSize() == 0 || history2.GetSize() == 0 ? 0 :
+        std::max(history1.GetFrameState(0).frame, history2.GetFrameState(0).frame);
+    if (history1.FindFrameState(firstCommonFrame) == nullptr || history2.FindFrameState(firstCommonFrame) == nullptr)
+    {
+        fmt::print("The dumps have no common frame\n");
+        return EXIT_FAILURE;
+    }
+    const auto divergence = game::FindDivergence(history1, history2);
+    if (!divergence.has_value())
+    {
+        fmt::print("No divergence in the common frames\n");
+        return EXIT_SUCCESS;
+    }
+    fmt::print("{}\n", game::ToString(*divergence));
+    const auto* frameState1 = history1.FindFrameState(divergence->frame);
+    const auto* frameState2 = history2.FindFrameState(divergence->frame);
+    std::string components;
+    for (std::size_t component = 0; component < game::stateComponentNmb; component++)
+    {
+        if (frameState1->hashes[component] != frameState2->hashes[component])
+        {
+            components += fmt::format("{}{}", components.empty() ? "" : ", ",
+                game::GetStateComponentName(static_cast<game::StateComponent>(component)));
+        }
+    }
+    fmt::print("Differing components at frame {}: {}\n", divergence->frame, components);
+    if (divergence->isFirstComparedFrame)
+    {
+        fmt::print("The states already differ on the first common frame, the desync may have started earlier\n");
+    }
+    return EXIT_FAILURE;
+}
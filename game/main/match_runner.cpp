@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include "network/match_runner.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+void PrintUsage()
+{
+    fmt::print("Usage: match_runner [--matches N] [--seed S] [--frames N] [--input-delay FRAMES] [--script PATH] [--record DIRECTORY] [--dump DIRECTORY] [--verbose]\n"
+        "                    [--link both|up|down] [--delay SECONDS] [--jitter SECONDS] [--distribution uniform|normal|exponential]\n"
+        "                    [--loss RATIO] [--burst-loss RATIO] [--burst-start RATIO] [--burst-end RATIO]\n"
+        "                    [--duplicate RATIO] [--reorder RATIO] [--reorder-delay SECONDS] [--bandwidth BYTES_PER_SECOND]\n"
+        "The link options apply to the direction selected by the last --link, both by default.\n"
+        "--record writes the recording of each match in DIRECTORY/match_SEED.rec.\n"
+        "--dump writes the state histories of the server and of the clients at the first desync in DIRECTORY/match_SEED_*.hash.\n");
+}
+
+constexpr std::array<std::string_view, 11> linkOptions
+{
+    "--delay", "--jitter", "--distribution", "--loss", "--burst-loss", "--burst-start", "--burst-end",
+    "--duplicate", "--reorder", "--reorder-delay", "--bandwidth"
+};
+
+bool SetLinkOption(std::string_view arg, const std::string& value, game::LinkConfig& linkConfig)
+{
+    if (arg == "--delay") linkConfig.delay = std::stof(value);
+    else if (arg == "--jitter") linkConfig.jitter = std::stof(value);
+    else if (arg == "--loss") linkConfig.lossGood = std::stof(value);
+    else if (arg == "--burst-loss") linkConfig.lossBad = std::stof(value);
+    else if (arg == "--burst-start") linkConfig.goodToBad = std::stof(value);
+    else if (arg == "--burst-end") linkConfig.badToGood = std::stof(value);
+    else if (arg == "--duplicate") linkConfig.duplicateRate = std::stof(value);
+    else if (arg == "--reorder") linkConfig.reorderRate = std::stof(value);
+    else if (arg == "--reorder-delay") linkConfig.reorderDelay = std::stof(value);
+    else if (arg == "--bandwidth") linkConfig.bandwidth = std::stof(value);
+    else if (arg == "--distribution" && value == "uniform") linkConfig.jitterDistribution = game::JitterDistribution::UNIFORM;
+    else if (arg == "--distribution" && value == "normal") linkConfig.jitterDistribution = game::JitterDistribution::NORMAL;
+    else if (arg == "--distribution" && value == "exponential") linkConfig.jitterDistribution = game::JitterDistribution::EXPONENTIAL;
+    else return false;
+    return true;
+}
+}
+
+int main(int argc, char** argv)
+{
+    game::MatchConfig config;
+    unsigned matchNmb = 1;
+    bool isVerbose = false;
+    bool isUplinkSelected = true;
+    bool isDownlinkSelected = true;
+    std::string recordDirectory;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--verbose")
+        {
+            isVerbose = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+        const std::string value = argv[++i];
+        if (std::find(linkOptions.begin(), linkOptions.end(), arg) != linkOptions.end())
+        {
+            if ((isUplinkSelected && !SetLinkOption(arg, value, config.uplink)) ||
+                (isDownlinkSelected && !SetLinkOption(arg, value, config.downlink)))
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        if (arg == "--link")
+        {
+            isUplinkSelected = value == "both" || value == "up";
+            isDownlinkSelected = value == "both" || value == "down";
+            if (!isUplinkSelected && !isDownlinkSelected)
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--matches") matchNmb = static_cast<unsigned>(std::stoul(value));
+        else if (arg == "--seed") config.seed = static_cast<std::uint32_t>(std::stoul(value));
+        else if (arg == "--frames") config.maxFrameNmb = static_cast<game::Frame>(std::stoul(value));
+        else if (arg == "--input-delay") config.inputDelay = static_cast<game::Frame>(std::stoul(value));
+        else if (arg == "--script") config.inputScript = game::LoadInputScript(value);
+        else if (arg == "--record") recordDirectory = value;
+        else if (arg == "--dump") config.dumpDirectory = value;
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (!isVerbose)
+    {
+        spdlog::set_level(spdlog::level::err);
+    }
+
+    const auto firstSeed = config.seed;
+    unsigned failedMatchNmb = 0;
+    double totalFramesPerSecond = 0.0;
+    for (unsigned match = 0; match < matchNmb; match++)
+    {
+        config.seed = firstSeed + match;
+        if (!recordDirectory.empty())
+        {
+            config.recordPath = fmt::format("{}/match_{}.rec", recordDirectory, config.seed);
+        }
+        game::MatchRunner runner(config);
+        const auto report = runner.Run();
+        fmt::print("seed {} frames {} winner {} fps {:.0f} rollback max {} mean {:.2f} desyncs {} batch desyncs {} spectator desyncs {}{}\n",
+            report.seed,
+            report.frameNmb,
+            report.winner == game::INVALID_PLAYER ? 0 : report.winner + 1,
+            report.framesPerSecond,
+            report.maxRollbackDepth,
+            report.meanRollbackDepth,
+            report.desyncNmb,
+            report.batchDesyncNmb,
+            report.spectatorDesyncNmb,
+            report.error.empty() ? "" : " error: " + report.error);
+        totalFramesPerSecond += report.framesPerSecond;
+        if (report.desyncNmb > 0 || report.batchDesyncNmb > 0 || report.spectatorDesyncNmb > 0 ||
+            !report.error.empty())
+        {
+            failedMatchNmb++;
+        }
+    }
+    fmt::print("{} matches, {} failed, mean fps {:.0f}\n", matchNmb, failedMatchNmb,
+        matchNmb > 0 ? totalFramesPerSecond / matchNmb : 0.0);
+    return failedMatchNmb == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
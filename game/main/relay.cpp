@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <SFML/System/Clock.hpp>
+
+#include "network/spectator_relay.h"
+
+#include <fmt/format.h>
+
+namespace
+{
+void PrintUsage()
+{
+    fmt::print("Usage: relay HOST PORT [--listen PORT] [--delay SECONDS]\n"
+        "Receives the match stream of the server relay port, or of another relay, at HOST:PORT\n"
+        "and sends it to the spectators connecting to the listen port, SECONDS later.\n");
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    const std::string host = argv[1];
+    const auto upstreamPort = static_cast<unsigned short>(std::stoi(argv[2]));
+    unsigned short listenPort = 0;
+    double delay = 0.0;
+    for (int i = 3; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--listen" && i + 1 < argc)
+        {
+            listenPort = static_cast<unsigned short>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--delay" && i + 1 < argc)
+        {
+            delay = std::stod(argv[++i]);
+        }
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    game::SpectatorRelay relay(static_cast<long long>(delay * 1000.0));
+    relay.SetUpstream(host, upstreamPort);
+    if (listenPort != 0)
+    {
+        relay.SetListenPort(listenPort);
+    }
+    relay.Begin();
+    if (!relay.IsOpen())
+    {
+        return EXIT_FAILURE;
+    }
+    fmt::print("relaying {}:{} on port {} with a delay of {}s\n", host, upstreamPort, relay.GetListenPort(), delay);
+    sf::Clock clock;
+    while (relay.IsOpen())
+    {
+        const auto dt = clock.restart();
+        relay.Update(dt);
+        //The stream only changes when the server validates frames, the relay does not need to spin
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    relay.End();
+    return EXIT_SUCCESS;
+}
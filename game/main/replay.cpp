@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game/game_manager.h"
+#include "network/match_replay.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+void PrintUsage()
+{
+    fmt::print("Usage: replay RECORDING [--seek FRAME]... [--dump-hashes FRAME PATH] [--verbose]\n"
+        "Without --seek, the whole match is replayed and the state hash of every frame is compared with the recorded one.\n"
+        "Each --seek prints the time spent to reach the frame and the state of the players.\n"
+        "--dump-hashes replays the validated frames up to FRAME and dumps the server state history in PATH, for desync_bisect.\n");
+}
+
+void PrintPlayers(const game::GameManager& gameManager)
+{
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::maxPlayerNmb; playerNumber++)
+    {
+        const auto entity = gameManager.GetEntityFromPlayerNumber(playerNumber);
+        const auto position = rollbackManager.GetTransformManager().GetPosition(entity);
+        const auto& playerCharacter = rollbackManager.GetPlayerCharacterManager().GetComponent(entity);
+        fmt::print("  P{} position ({:.3f}, {:.3f}) health {}\n", playerNumber + 1, position.x, position.y, playerCharacter.health);
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    const std::string path = argv[1];
+    std::vector<game::Frame> seekFrames;
+    game::Frame dumpFrame = 0;
+    std::string dumpPath;
+    bool isVerbose = false;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--verbose")
+        {
+            isVerbose = true;
+        }
+        else if (arg == "--seek" && i + 1 < argc)
+        {
+            seekFrames.push_back(static_cast<game::Frame>(std::stoul(argv[++i])));
+        }
+        else if (arg == "--dump-hashes" && i + 2 < argc)
+        {
+            dumpFrame = static_cast<game::Frame>(std::stoul(argv[++i]));
+            dumpPath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (!isVerbose)
+    {
+        spdlog::set_level(spdlog::level::err);
+    }
+
+    game::MatchRecording recording;
+    if (!recording.Load(path))
+    {
+        return EXIT_FAILURE;
+    }
+    fmt::print("{} frames, {} keyframes, winner {}\n", recording.GetLastFrame(), recording.GetKeyframes().size(),
+        recording.GetWinner() == game::INVALID_PLAYER ? 0 : recording.GetWinner() + 1);
+
+    game::ReplayPlayer replayPlayer(recording);
+    if (!replayPlayer.IsValid())
+    {
+        return EXIT_FAILURE;
+    }
+    if (!dumpPath.empty())
+    {
+        //Only the last stateHistorySize validated frames are kept, the ones before are reached from a keyframe
+        replayPlayer.Seek(dumpFrame > game::stateHistorySize ? dumpFrame - static_cast<game::Frame>(game::stateHistorySize) : 0);
+        replayPlayer.Advance(dumpFrame > replayPlayer.GetFrame() ? dumpFrame - replayPlayer.GetFrame() : 0);
+        const auto& stateHistory = replayPlayer.GetGameManager().GetRollbackManager().GetStateHistory();
+        if (!replayPlayer.IsValid() || stateHistory.GetSize() == 0 || !stateHistory.Dump(dumpPath))
+        {
+            return EXIT_FAILURE;
+        }
+        fmt::print("state history of the frames {} to {} dumped in {}\n", stateHistory.GetFrameState(0).frame,
+            stateHistory.GetFrameState(stateHistory.GetSize() - 1).frame, dumpPath);
+        return EXIT_SUCCESS;
+    }
+    if (seekFrames.empty())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        replayPlayer.Advance(recording.GetLastFrame());
+        const auto end = std::chrono::steady_clock::now();
+        fmt::print("replayed {} frames in {:.1f}ms, desyncs {}", replayPlayer.GetFrame(),
+            std::chrono::duration<double, std::milli>(end - start).count(), replayPlayer.GetDesyncNmb());
+        if (replayPlayer.GetDesyncNmb() > 0)
+        {
+            fmt::print(" first desync at frame {}", replayPlayer.GetFirstDesyncFrame());
+        }
+        fmt::print("\n");
+        PrintPlayers(replayPlayer.GetGameManager());
+        return replayPlayer.GetDesyncNmb() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    for (const auto frame : seekFrames)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        replayPlayer.Seek(frame);
+        if (!replayPlayer.IsValid())
+        {
+            return EXIT_FAILURE;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        fmt::print("frame {} reached in {:.2f}ms\n", replayPlayer.GetFrame(),
+            std::chrono::duration<double, std::milli>(end - start).count());
+        PrintPlayers(replayPlayer.GetGameManager());
+    }
+    return EXIT_SUCCESS;
+}
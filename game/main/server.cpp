@@ -5,7 +5,7 @@
 int main(int argc, char** argv)
 {
     unsigned short port = 0;
-    if (argc == 2)
+    if (argc >= 2)
     {
         const std::string portArg = argv[1];
         port = static_cast<unsigned short>(std::stoi(portArg));
@@ -15,6 +15,16 @@ int main(int argc, char** argv)
     {
         server.SetTcpPort(port);
     }
+    //The optional second argument is the file where the match is recorded
+    if (argc >= 3)
+    {
+        server.StartRecording(argv[2]);
+    }
+    //The optional third argument is the port the spectator relays connect to
+    if (argc >= 4)
+    {
+        server.SetRelayPort(static_cast<unsigned short>(std::stoi(argv[3])));
+    }
     server.Begin();
     sf::Clock clock;
     while (server.IsOpen())
@@ -22,5 +32,6 @@ int main(int argc, char** argv)
         const auto dt = clock.restart();
         server.Update(dt);
     }
+    server.End();
     return 0;
 }
@@ -0,0 +1,100 @@
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "game/game_manager.h"
+#include "network/spectator_relay.h"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+void PrintUsage()
+{
+    fmt::print("Usage: spectate HOST PORT [--verbose]\n"
+        "Follows the match streamed by a relay, or by the server relay port, at HOST:PORT.\n"
+        "The validated frames are replayed as they arrive and their state hashes are compared with the server ones.\n");
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    const std::string host = argv[1];
+    const auto port = static_cast<unsigned short>(std::stoi(argv[2]));
+    bool isVerbose = false;
+    for (int i = 3; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--verbose")
+        {
+            isVerbose = true;
+        }
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (!isVerbose)
+    {
+        spdlog::set_level(spdlog::level::err);
+    }
+
+    sf::TcpSocket socket;
+    if (socket.connect(host, port) != sf::Socket::Done)
+    {
+        fmt::print("Could not connect to {}:{}\n", host, port);
+        return EXIT_FAILURE;
+    }
+    game::MatchRecording recording;
+    //The replay player starts from the first keyframe, it is created once it is received
+    std::unique_ptr<game::ReplayPlayer> replayPlayer;
+    std::array<std::byte, game::relayReceiveSize> buffer{};
+    std::size_t received = 0;
+    while (socket.receive(buffer.data(), buffer.size(), received) == sf::Socket::Done)
+    {
+        if (!recording.Append(buffer.data(), received))
+        {
+            return EXIT_FAILURE;
+        }
+        if (replayPlayer == nullptr)
+        {
+            if (recording.GetKeyframes().empty())
+            {
+                continue;
+            }
+            replayPlayer = std::make_unique<game::ReplayPlayer>(recording);
+            if (!replayPlayer->IsValid())
+            {
+                return EXIT_FAILURE;
+            }
+            fmt::print("joined at frame {}\n", recording.GetFirstFrame());
+        }
+        const auto lastFrame = replayPlayer->GetFrame();
+        replayPlayer->Advance(recording.GetLastFrame() - lastFrame);
+        if (replayPlayer->GetFrame() / game::recordingKeyframePeriod > lastFrame / game::recordingKeyframePeriod)
+        {
+            fmt::print("frame {}, desyncs {}\n", replayPlayer->GetFrame(), replayPlayer->GetDesyncNmb());
+        }
+    }
+    if (replayPlayer == nullptr)
+    {
+        fmt::print("The stream ended before its first keyframe\n");
+        return EXIT_FAILURE;
+    }
+    fmt::print("watched frames {} to {}, desyncs {}", recording.GetFirstFrame(), replayPlayer->GetFrame(), replayPlayer->GetDesyncNmb());
+    if (replayPlayer->GetDesyncNmb() > 0)
+    {
+        fmt::print(" first desync at frame {}", replayPlayer->GetFirstDesyncFrame());
+    }
+    fmt::print(", winner {}\n", recording.GetWinner() == game::INVALID_PLAYER ? 0 : recording.GetWinner() + 1);
+    return replayPlayer->GetDesyncNmb() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
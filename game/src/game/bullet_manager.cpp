@@ -17,20 +17,16 @@ void BulletManager::FixedUpdate(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    //Destroying a bullet changes the viewed entities, the loop iterates over a copy
+    for (const auto entity : entityManager_.View(
+        static_cast<core::EntityMask>(ComponentType::BULLET),
+        static_cast<core::EntityMask>(ComponentType::DESTROYED)).ToVector())
     {
-        if(entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        auto& bullet = components_[entity];
+        bullet.remainingTime -= dt.asSeconds();
+        if (bullet.remainingTime < 0.0f)
         {
-            continue;
-        }
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::BULLET)))
-        {
-            auto& bullet = components_[entity];
-            bullet.remainingTime -= dt.asSeconds();
-            if (bullet.remainingTime < 0.0f)
-            {
-                gameManager_.DestroyBullet(entity);
-            }
+            gameManager_.DestroyBullet(entity);
         }
     }
 }
@@ -0,0 +1,709 @@
+
+#include "game/client_game_manager.h"
+
+#include "utils/log.h"
+
+#include "maths/basic.h"
+#include "network/clock_sync.h"
+#include "utils/conversion.h"
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <fmt/format.h>
+#include <imgui.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+
+ClientGameManager::ClientGameManager(PacketSenderInterface& packetSenderInterface) :
+    GameManager(),
+    packetSenderInterface_(packetSenderInterface),
+    renderTransformManager_(renderEntityManager_),
+    spriteManager_(renderEntityManager_, renderTransformManager_)
+{
+}
+
+ClientGameManager::~ClientGameManager()
+{
+    End();
+}
+
+void ClientGameManager::Begin()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!isHeadless_)
+    {
+        //load textures
+        if (!bulletTexture_.loadFromFile("data/sprites/bullet.png"))
+        {
+            core::LogError("Could not load bullet sprite");
+        }
+        if (!shipTexture_.loadFromFile("data/sprites/ship.png"))
+        {
+            core::LogError("Could not load ship sprite");
+        }
+        //load fonts
+        if (!font_.loadFromFile("data/fonts/8-bit-hud.ttf"))
+        {
+            core::LogError("Could not load font");
+        }
+        textRenderer_.setFont(font_);
+        starBackground_.Init();
+    }
+
+    if (speculativeBranchCount_ > 0)
+    {
+        speculativeSimulator_.Start(speculativeBranchCount_);
+    }
+    if (isSimulationThreaded_)
+    {
+        isSimulationRunning_.store(true, std::memory_order_release);
+        simulationThread_ = std::thread(&ClientGameManager::SimulationLoop, this);
+    }
+}
+
+void ClientGameManager::Update(sf::Time dt)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (isSimulationThreaded_)
+    {
+        if (simulationThread_.joinable() && !isSimulationRunning_.load(std::memory_order_acquire))
+        {
+            simulationThread_.join();
+            if (simulationException_)
+            {
+                std::rethrow_exception(simulationException_);
+            }
+        }
+    }
+    else
+    {
+        ApplyLocalPlayerInput();
+        SimulateToCurrentFrame();
+        fixedTimer_ += dt.asSeconds();
+        while (fixedTimer_ > GetFixedPeriod())
+        {
+            FixedUpdate();
+            fixedTimer_ -= GetFixedPeriod();
+
+        }
+    }
+    if (isHeadless_)
+    {
+        return;
+    }
+    if (renderSnapshots_.Acquire())
+    {
+        renderInterpolator_.PushSnapshot(renderSnapshots_.GetReadBuffer());
+        UpdateRenderWorld();
+    }
+    renderInterpolator_.Update(dt.asSeconds());
+    InterpolateRenderWorld();
+}
+
+void ClientGameManager::End()
+{
+    if (simulationThread_.joinable())
+    {
+        isSimulationRunning_.store(false, std::memory_order_release);
+        simulationThread_.join();
+    }
+    speculativeSimulator_.Stop();
+}
+
+void ClientGameManager::SimulationLoop()
+{
+#ifdef TRACY_ENABLE
+    tracy::SetThreadName("Simulation");
+#endif
+    using namespace std::chrono;
+    auto nextFrameTime = steady_clock::now();
+    try
+    {
+        while (isSimulationRunning_.load(std::memory_order_acquire))
+        {
+            //The period changes with the frame advantage received from the server
+            steady_clock::duration period{};
+            {
+                std::scoped_lock lock(simulationMutex_);
+                ApplyLocalPlayerInput();
+                SimulateToCurrentFrame();
+                FixedUpdate();
+                period = duration_cast<steady_clock::duration>(duration<float>(GetFixedPeriod()));
+            }
+            nextFrameTime += period;
+            std::this_thread::sleep_until(nextFrameTime);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        core::LogError(fmt::format("Simulation thread stopped: {}", e.what()));
+        simulationException_ = std::current_exception();
+        isSimulationRunning_.store(false, std::memory_order_release);
+    }
+}
+
+void ClientGameManager::SimulateToCurrentFrame()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (state_ & STARTED)
+    {
+        rollbackManager_.SimulateToCurrentFrame(speculativeSimulator_.FindBranch(rollbackManager_));
+        speculativeSimulator_.Speculate(rollbackManager_, clientPlayer_);
+#ifdef TRACY_ENABLE
+        TracyPlot("Rollback Depth", static_cast<std::int64_t>(
+            rollbackManager_.GetCurrentFrame() - rollbackManager_.GetLastValidateFrame()));
+        TracyPlot("Entity Count", static_cast<std::int64_t>(entityManager_.GetEntityCount()));
+        TracyPlot("Bullet Count", static_cast<std::int64_t>(
+            entityManager_.GetEntityCount(static_cast<core::EntityMask>(ComponentType::BULLET))));
+#endif
+    }
+    if (!isHeadless_)
+    {
+        PublishRenderSnapshot();
+    }
+}
+
+void ClientGameManager::PublishRenderSnapshot()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    auto& snapshot = renderSnapshots_.GetWriteBuffer();
+    snapshot.frame = currentFrame_;
+    snapshot.state = state_;
+    snapshot.inputDelay = inputDelay_;
+    snapshot.winner = winner_;
+    snapshot.startingTime = startingTime_;
+    snapshot.frameAdvantage = frameAdvantage_;
+    snapshot.fixedPeriod = GetFixedPeriod();
+    snapshot.entityMasks = entityManager_.GetAllEntityMasks();
+    //The rollback transforms are already the predicted frame, copied in bulk
+    const auto& transformManager = rollbackManager_.GetTransformManager();
+    snapshot.positions = transformManager.GetAllPositions();
+    snapshot.scales = transformManager.GetAllScales();
+    snapshot.rotations = transformManager.GetAllRotations();
+    snapshot.colors.resize(snapshot.entityMasks.size());
+
+    const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
+    const auto& bulletManager = rollbackManager_.GetBulletManager();
+    for (const auto entity : entityManager_.View<ComponentType::PLAYER_CHARACTER>())
+    {
+        const auto& player = playerManager.GetComponent(entity);
+        if (player.invincibilityTime > 0.0f &&
+            std::fmod(player.invincibilityTime, invincibilityFlashPeriod) > invincibilityFlashPeriod / 2.0f)
+        {
+            snapshot.colors[entity] = core::Color::black();
+        }
+        else
+        {
+            snapshot.colors[entity] = playerColors[player.playerNumber];
+        }
+    }
+    for (const auto entity : entityManager_.View<ComponentType::BULLET>())
+    {
+        snapshot.colors[entity] = playerColors[bulletManager.GetComponent(entity).playerNumber];
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        const auto playerEntity = GetEntityFromPlayerNumber(playerNumber);
+        snapshot.playerEntities[playerNumber] = playerEntity;
+        snapshot.playerHealths[playerNumber] = playerEntity == core::INVALID_ENTITY ?
+            0 : playerManager.GetComponent(playerEntity).health;
+    }
+    snapshot.colliders.clear();
+    if (drawPhysics_.load(std::memory_order_relaxed))
+    {
+        const auto& physicsManager = rollbackManager_.GetCurrentPhysicsManager();
+        for (const auto entity : entityManager_.View(
+            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
+            static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D),
+            static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        {
+            snapshot.colliders.push_back({ physicsManager.GetBody(entity).position, physicsManager.GetBox(entity).extends });
+        }
+    }
+    renderSnapshots_.Publish();
+}
+
+void ClientGameManager::UpdateRenderWorld()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto& snapshot = renderSnapshots_.GetReadBuffer();
+    renderEntityManager_.CopyAllEntityMasks(snapshot.entityMasks);
+    renderTransformManager_.CopyAllPositions(snapshot.positions);
+    renderTransformManager_.CopyAllScales(snapshot.scales);
+    renderTransformManager_.CopyAllRotations(snapshot.rotations);
+    //Entities destroyed in the predicted frames are not drawn
+    const auto addSprites = [this, &snapshot](ComponentType type, const sf::Texture& texture)
+    {
+        for (const auto entity : renderEntityManager_.View(
+            static_cast<core::EntityMask>(type),
+            static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        {
+            spriteManager_.AddComponent(entity);
+            spriteManager_.SetTexture(entity, texture);
+            spriteManager_.SetOrigin(entity, sf::Vector2f(texture.getSize()) / 2.0f);
+            spriteManager_.SetColor(entity, snapshot.colors[entity]);
+        }
+    };
+    addSprites(ComponentType::PLAYER_CHARACTER, shipTexture_);
+    addSprites(ComponentType::BULLET, bulletTexture_);
+}
+
+void ClientGameManager::InterpolateRenderWorld()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    for (const auto entity : renderEntityManager_.View<core::ComponentType::SPRITE>())
+    {
+        renderTransformManager_.SetPosition(entity, renderInterpolator_.GetPosition(entity));
+        renderTransformManager_.SetRotation(entity, renderInterpolator_.GetRotation(entity));
+    }
+}
+
+void ClientGameManager::SetWindowSize(sf::Vector2u windowsSize)
+{
+    windowSize_ = windowsSize;
+    const sf::FloatRect visibleArea(0.0f, 0.0f,
+        static_cast<float>(windowSize_.x),
+        static_cast<float>(windowSize_.y));
+    originalView_ = sf::View(visibleArea);
+    spriteManager_.SetWindowSize(sf::Vector2f(windowsSize));
+    spriteManager_.SetCenter(sf::Vector2f(windowsSize) / 2.0f);
+}
+
+void ClientGameManager::Draw(sf::RenderTarget& target)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    UpdateCameraView();
+    target.setView(cameraView_);
+
+    starBackground_.Draw(target);
+    spriteManager_.Draw(target);
+
+    if(drawPhysics_.load(std::memory_order_relaxed))
+    {
+        DrawPhysics(target);
+    }
+
+    // Draw texts on screen
+    target.setView(originalView_);
+    const auto& snapshot = renderSnapshots_.GetReadBuffer();
+    if (snapshot.state & FINISHED)
+    {
+        if (snapshot.winner == GetPlayerNumber())
+        {
+            const std::string winnerText = fmt::format("You won!");
+            textRenderer_.setFillColor(sf::Color::White);
+            textRenderer_.setString(winnerText);
+            textRenderer_.setCharacterSize(32);
+            const auto textBounds = textRenderer_.getLocalBounds();
+            textRenderer_.setPosition(static_cast<float>(windowSize_.x) / 2.0f - textBounds.width / 2.0f,
+                static_cast<float>(windowSize_.y) / 2.0f - textBounds.height / 2.0f);
+            target.draw(textRenderer_);
+        }
+        else if (snapshot.winner != INVALID_PLAYER)
+        {
+            const std::string winnerText = fmt::format("P{} won!", snapshot.winner + 1);
+            textRenderer_.setFillColor(sf::Color::White);
+            textRenderer_.setString(winnerText);
+            textRenderer_.setCharacterSize(32);
+            const auto textBounds = textRenderer_.getLocalBounds();
+            textRenderer_.setPosition(static_cast<float>(windowSize_.x) / 2.0f - textBounds.width / 2.0f,
+                static_cast<float>(windowSize_.y) / 2.0f - textBounds.height / 2.0f);
+            target.draw(textRenderer_);
+        }
+        else
+        {
+            const std::string errorMessage = fmt::format("Error with other players");
+            textRenderer_.setFillColor(sf::Color::Red);
+            textRenderer_.setString(errorMessage);
+            textRenderer_.setCharacterSize(32);
+            const auto textBounds = textRenderer_.getLocalBounds();
+            textRenderer_.setPosition(static_cast<float>(windowSize_.x) / 2.0f - textBounds.width / 2.0f,
+                static_cast<float>(windowSize_.y) / 2.0f - textBounds.height / 2.0f);
+            target.draw(textRenderer_);
+        }
+    }
+    if (!(snapshot.state & STARTED))
+    {
+        if (snapshot.startingTime != 0)
+        {
+            const auto ms = static_cast<unsigned long long>(GetClockTime());
+            if (ms < snapshot.startingTime)
+            {
+                const std::string countDownText = fmt::format("Starts in {}", ((snapshot.startingTime - ms) / 1000 + 1));
+                textRenderer_.setFillColor(sf::Color::White);
+                textRenderer_.setString(countDownText);
+                textRenderer_.setCharacterSize(32);
+                const auto textBounds = textRenderer_.getLocalBounds();
+                textRenderer_.setPosition(static_cast<float>(windowSize_.x) / 2.0f - textBounds.width / 2.0f,
+                    static_cast<float>(windowSize_.y) / 2.0f - textBounds.height / 2.0f);
+                target.draw(textRenderer_);
+            }
+        }
+    }
+    else
+    {
+        std::string health;
+        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            if (snapshot.playerEntities[playerNumber] == core::INVALID_ENTITY)
+            {
+                continue;
+            }
+            health += fmt::format("P{} health: {} ", playerNumber + 1, snapshot.playerHealths[playerNumber]);
+        }
+        textRenderer_.setFillColor(sf::Color::White);
+        textRenderer_.setString(health);
+        textRenderer_.setPosition(10, 10);
+        textRenderer_.setCharacterSize(20);
+        target.draw(textRenderer_);
+    }
+
+}
+
+void ClientGameManager::DrawPhysics(sf::RenderTarget& target)
+{
+    const auto& snapshot = renderSnapshots_.GetReadBuffer();
+    const sf::Vector2f windowSize(windowSize_);
+    const auto center = windowSize / 2.0f;
+    for (const auto& [position, extends] : snapshot.colliders)
+    {
+        sf::RectangleShape rectShape;
+        rectShape.setFillColor(core::Color::transparent());
+        rectShape.setOutlineColor(core::Color::green());
+        rectShape.setOutlineThickness(2.0f);
+        rectShape.setOrigin({ extends.x * core::pixelPerMeter, extends.y * core::pixelPerMeter });
+        rectShape.setPosition(
+            position.x * core::pixelPerMeter + center.x,
+            windowSize.y - (position.y * core::pixelPerMeter + center.y));
+        rectShape.setSize({ extends.x * 2.0f * core::pixelPerMeter, extends.y * 2.0f * core::pixelPerMeter });
+        target.draw(rectShape);
+    }
+}
+
+void ClientGameManager::SetClientPlayer(PlayerNumber clientPlayer)
+{
+    clientPlayer_ = clientPlayer;
+    rollbackManager_.SetDesyncDumpPath(fmt::format("desync_p{}", clientPlayer + 1));
+}
+
+void ClientGameManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Degree rotation)
+{
+    core::LogDebug(fmt::format("Spawn player: {}", playerNumber));
+
+    GameManager::SpawnPlayer(playerNumber, position, rotation);
+}
+
+
+void ClientGameManager::FixedUpdate()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!(state_ & STARTED))
+    {
+        if (startingTime_ != 0)
+        {
+            const auto ms = static_cast<unsigned long long>(GetClockTime());
+            if (ms > startingTime_)
+            {
+                state_ = state_ | STARTED;
+            }
+            else
+            {
+
+                return;
+            }
+        }
+        else
+        {
+            return;
+        }
+    }
+    if (state_ & FINISHED)
+    {
+        return;
+    }
+
+    //We send the player inputs when the game started
+    const auto playerNumber = GetPlayerNumber();
+    if (playerNumber == INVALID_PLAYER)
+    {
+        //We still did not receive the spawn player packet, but receive the start game packet
+        core::LogWarning(fmt::format("Invalid Player Entity in {}:line {}", __FILE__, __LINE__));
+        return;
+    }
+    auto inputFrame = currentFrame_ + inputDelay_;
+    if (hasSentInput_ && inputFrame <= lastSentInputFrame_)
+    {
+        //The input delay shrank, this input frame was already sent and cannot change anymore
+        inputFrame = lastSentInputFrame_;
+    }
+    else
+    {
+        //Commit the last sampled input, even if it was not sampled during this frame
+        SetPlayerInput(playerNumber, localInput_.load(std::memory_order_relaxed), inputFrame);
+    }
+    //The input window can start after inputFrame when the remote inputs are further ahead
+    const auto& inputs = rollbackManager_.GetInputs(playerNumber);
+    const auto inputIndex = rollbackManager_.GetCurrentFrame() - inputFrame;
+    auto playerInputPacket = std::make_unique<PlayerInputPacket>();
+    playerInputPacket->playerNumber = playerNumber;
+    playerInputPacket->currentFrame = core::ConvertToBinary(inputFrame);
+    playerInputPacket->simulationFrame = core::ConvertToBinary(currentFrame_);
+    for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+    {
+        if (i > inputFrame || inputIndex + i >= inputs.size())
+        {
+            break;
+        }
+
+        playerInputPacket->inputs[i] = inputs[inputIndex + i];
+    }
+    packetSenderInterface_.SendUnreliablePacket(std::move(playerInputPacket));
+    lastSentInputFrame_ = inputFrame;
+    hasSentInput_ = true;
+
+
+    currentFrame_++;
+    rollbackManager_.StartNewFrame(currentFrame_);
+    ConfirmPendingValidateFrame();
+}
+
+
+void ClientGameManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame)
+{
+    if (playerNumber == INVALID_PLAYER)
+        return;
+    GameManager::SetPlayerInput(playerNumber, playerInput, inputFrame);
+}
+
+void ClientGameManager::SetLocalPlayerInput(PlayerInput playerInput)
+{
+    localInput_.store(playerInput, std::memory_order_relaxed);
+}
+
+void ClientGameManager::ApplyLocalPlayerInput()
+{
+    const auto inputFrame = currentFrame_ + inputDelay_;
+    if (hasSentInput_ && inputFrame <= lastSentInputFrame_)
+    {
+        //The input delay shrank, the input waits for the next frame that was not sent
+        return;
+    }
+    SetPlayerInput(clientPlayer_, localInput_.load(std::memory_order_relaxed), inputFrame);
+}
+
+void ClientGameManager::SetInputDelay(Frame inputDelay)
+{
+    inputDelay_ = std::min(inputDelay, maxInputDelay);
+}
+
+void ClientGameManager::SetFrameAdvantage(float frameAdvantage)
+{
+    frameAdvantage_ = frameAdvantage;
+    if (std::abs(frameAdvantage) < minFrameAdvantage)
+    {
+        fixedPeriodScale_ = 1.0f;
+        return;
+    }
+    //Being ahead lengthens the period so the others catch up, being behind shortens it
+    fixedPeriodScale_ = 1.0f + std::clamp(frameAdvantage * frameAdvantageSlewRate, -maxFixedPeriodSlew, maxFixedPeriodSlew);
+}
+
+void ClientGameManager::StartGame(unsigned long long int startingTime)
+{
+    core::LogDebug(fmt::format("Start game at starting time: {}", startingTime));
+    startingTime_ = startingTime;
+}
+
+void ClientGameManager::DrawImGui()
+{
+    const auto& snapshot = renderSnapshots_.GetReadBuffer();
+    ImGui::Text(snapshot.state & STARTED ? "Game has started" : "Game has not started");
+    if (snapshot.startingTime != 0)
+    {
+        ImGui::Text("Starting Time: %llu", snapshot.startingTime);
+        ImGui::Text("Current Time: %lld", GetClockTime());
+    }
+    ImGui::Text("Render frame: %u", snapshot.frame);
+    ImGui::Text("Input delay: %u frames", snapshot.inputDelay);
+    ImGui::Text("Frame advantage: %.2f frames", snapshot.frameAdvantage);
+    bool isDrawingPhysics = drawPhysics_.load(std::memory_order_relaxed);
+    if (ImGui::Checkbox("Draw Physics", &isDrawingPhysics))
+    {
+        drawPhysics_.store(isDrawingPhysics, std::memory_order_relaxed);
+    }
+    bool isInterpolating = renderInterpolator_.IsEnabled();
+    if (ImGui::Checkbox("Render Interpolation", &isInterpolating))
+    {
+        renderInterpolator_.SetEnabled(isInterpolating);
+    }
+    bool isBatching = spriteManager_.IsBatching();
+    if (ImGui::Checkbox("Sprite Batching", &isBatching))
+    {
+        spriteManager_.SetBatching(isBatching);
+    }
+    if (speculativeSimulator_.IsRunning())
+    {
+        ImGui::Text("Speculative branches adopted: %zu", speculativeSimulator_.GetAdoptedBranchCount());
+    }
+    DrawRollbackTelemetryImGui();
+}
+
+void ClientGameManager::DrawRollbackTelemetryImGui()
+{
+    if (!ImGui::CollapsingHeader("Rollback Telemetry"))
+    {
+        return;
+    }
+    //The telemetry is lock-free, it is read without the simulation mutex
+    auto& telemetry = rollbackManager_.GetTelemetry();
+    const auto& resimulatedFrames = telemetry.GetResimulatedFrames();
+    std::array<float, RollbackTelemetry::FrameHistogram::GetBucketNmb()> buckets{};
+    for (std::size_t i = 0; i < buckets.size(); i++)
+    {
+        buckets[i] = static_cast<float>(resimulatedFrames.GetBucketCount(i));
+    }
+    ImGui::Text("Updates: %llu", static_cast<unsigned long long>(resimulatedFrames.GetCount()));
+    ImGui::Text("Resimulated frames mean: %.2f max: %llu", resimulatedFrames.GetMean(),
+        static_cast<unsigned long long>(resimulatedFrames.GetMax()));
+    ImGui::PlotHistogram("Resimulated frames (log2)", buckets.data(), static_cast<int>(buckets.size()));
+    ImGui::Text("Restore mean: %.1f us", telemetry.GetRestoreTime().GetMean() / 1000.0);
+    ImGui::Text("Simulate mean: %.1f us p95: < %.1f us", telemetry.GetSimulateTime().GetMean() / 1000.0,
+        static_cast<double>(telemetry.GetSimulateTime().GetPercentile(0.95)) / 1000.0);
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        ImGui::Text("Mispredicted inputs P%u: %llu", playerNumber + 1,
+            static_cast<unsigned long long>(telemetry.GetMispredictedInputs(playerNumber)));
+    }
+    ImGui::Text("Validation lag mean: %.2f max: %llu frames", telemetry.GetValidationLag().GetMean(),
+        static_cast<unsigned long long>(telemetry.GetValidationLag().GetMax()));
+    if (ImGui::Button("Reset Telemetry"))
+    {
+        telemetry.Reset();
+    }
+}
+
+void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
+    const std::array<PhysicsState, maxPlayerNmb>& physicsStates)
+{
+    if (newValidateFrame < rollbackManager_.GetLastValidateFrame())
+    {
+        core::LogWarning(fmt::format("New validate frame is too old"));
+        return;
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        if (rollbackManager_.GetLastReceivedFrame(playerNumber) < newValidateFrame)
+        {
+            
+            core::LogWarning(fmt::format("Trying to validate frame {} while playerNumber {} is at input frame {}, client player {}",
+                newValidateFrame,
+                playerNumber + 1,
+                rollbackManager_.GetLastReceivedFrame(playerNumber),
+                GetPlayerNumber()+1));
+            
+
+            return;
+        }
+    }
+    if (newValidateFrame > currentFrame_)
+    {
+        //The inputs are delayed, this frame is validated before being simulated
+        pendingValidateFrame_ = newValidateFrame;
+        pendingPhysicsStates_ = physicsStates;
+        return;
+    }
+    rollbackManager_.ConfirmFrame(newValidateFrame, physicsStates);
+}
+
+void ClientGameManager::ConfirmPendingValidateFrame()
+{
+    if (pendingValidateFrame_ == 0 || pendingValidateFrame_ > currentFrame_)
+    {
+        return;
+    }
+    rollbackManager_.ConfirmFrame(pendingValidateFrame_, pendingPhysicsStates_);
+    pendingValidateFrame_ = 0;
+}
+
+void ClientGameManager::WinGame(PlayerNumber winner)
+{
+    GameManager::WinGame(winner);
+    state_ = state_ | FINISHED;
+}
+
+void ClientGameManager::UpdateCameraView()
+{
+    const auto& snapshot = renderSnapshots_.GetReadBuffer();
+    if ((snapshot.state & STARTED) != STARTED)
+    {
+        cameraView_ = originalView_;
+        return;
+    }
+
+    cameraView_ = originalView_;
+    const sf::Vector2f extends{ cameraView_.getSize() / 2.0f / core::pixelPerMeter };
+    float currentZoom = 1.0f;
+    constexpr float margin = 1.0f;
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        const auto playerEntity = snapshot.playerEntities[playerNumber];
+        if (playerEntity == core::INVALID_ENTITY)
+        {
+            continue;
+        }
+        if (renderEntityManager_.HasComponent(playerEntity, static_cast<core::EntityMask>(core::ComponentType::POSITION)))
+        {
+            const auto position = renderTransformManager_.GetPosition(playerEntity);
+            if (core::Abs(position.x) + margin > extends.x)
+            {
+                const auto ratio = (std::abs(position.x) + margin) / extends.x;
+                if (ratio > currentZoom)
+                {
+                    currentZoom = ratio;
+                }
+            }
+            if (core::Abs(position.y) + margin > extends.y)
+            {
+                const auto ratio = (std::abs(position.y) + margin) / extends.y;
+                if (ratio > currentZoom)
+                {
+                    currentZoom = ratio;
+                }
+            }
+        }
+    }
+    cameraView_.zoom(currentZoom);
+
+}
+}
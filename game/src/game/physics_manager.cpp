@@ -1,8 +1,6 @@
 #include "game/physics_manager.h"
 #include "engine/transform.h"
 
-#include <SFML/Graphics/RectangleShape.hpp>
-
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
@@ -29,28 +27,37 @@ void PhysicsManager::FixedUpdate(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (const auto entity : entityManager_.View<core::ComponentType::BODY2D>())
     {
-        if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BODY2D)))
-            continue;
         auto body = bodyManager_.GetComponent(entity);
         body.position += body.velocity * dt.asSeconds();
         body.rotation += body.angularVelocity * dt.asSeconds();
         bodyManager_.SetComponent(entity, body);
     }
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    constexpr auto colliderMask = static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
+        static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D);
+    //The trigger actions can destroy the colliders, the loop iterates over a copy and skips the destroyed ones
+    const auto isDestroyed = [this](core::Entity entity)
+    {
+        return !entityManager_.HasComponent(entity, colliderMask) ||
+            entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+    };
+    const auto colliders = entityManager_.View(colliderMask,
+        static_cast<core::EntityMask>(ComponentType::DESTROYED)).ToVector();
+    for (std::size_t colliderIndex = 0; colliderIndex < colliders.size(); colliderIndex++)
     {
-        if (!entityManager_.HasComponent(entity,
-            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-            static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-            entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-            continue;
-        for (core::Entity otherEntity = entity + 1; otherEntity < entityManager_.GetEntitiesSize(); otherEntity++)
+        const auto entity = colliders[colliderIndex];
+        for (std::size_t otherColliderIndex = colliderIndex + 1; otherColliderIndex < colliders.size(); otherColliderIndex++)
         {
-            if (!entityManager_.HasComponent(otherEntity,
-                static_cast<core::EntityMask>(core::ComponentType::BODY2D) | static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-                entityManager_.HasComponent(otherEntity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+            const auto otherEntity = colliders[otherColliderIndex];
+            if (isDestroyed(entity))
+            {
+                break;
+            }
+            if (isDestroyed(otherEntity))
+            {
                 continue;
+            }
             const Body& body1 = bodyManager_.GetComponent(entity);
             const Box& box1 = boxManager_.GetComponent(entity);
 
@@ -116,28 +123,15 @@ void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
     boxManager_.CopyAllComponents(physicsManager.boxManager_.GetAllComponents());
 }
 
-void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
+void PhysicsManager::SaveComponents(core::SnapshotArena& arena) const
 {
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-    {
-        if (!entityManager_.HasComponent(entity,
-            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-            static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D)) ||
-            entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-            continue;
-        const auto& [extends, isTrigger] = boxManager_.GetComponent(entity);
-        const auto& body = bodyManager_.GetComponent(entity);
-        sf::RectangleShape rectShape;
-        rectShape.setFillColor(core::Color::transparent());
-        rectShape.setOutlineColor(core::Color::green());
-        rectShape.setOutlineThickness(2.0f);
-        const auto position = body.position;
-        rectShape.setOrigin({ extends.x * core::pixelPerMeter, extends.y * core::pixelPerMeter });
-        rectShape.setPosition(
-            position.x * core::pixelPerMeter + center_.x,
-            windowSize_.y - (position.y * core::pixelPerMeter + center_.y));
-        rectShape.setSize({ extends.x * 2.0f * core::pixelPerMeter, extends.y * 2.0f * core::pixelPerMeter });
-        renderTarget.draw(rectShape);
-    }
+    bodyManager_.SaveComponents(arena);
+    boxManager_.SaveComponents(arena);
+}
+
+void PhysicsManager::RestoreComponents(core::SnapshotArena& arena)
+{
+    bodyManager_.RestoreComponents(arena);
+    boxManager_.RestoreComponents(arena);
 }
 }
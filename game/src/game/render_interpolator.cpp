@@ -0,0 +1,169 @@
+#include "game/render_interpolator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "maths/basic.h"
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+void RenderInterpolator::PushSnapshot(const RenderSnapshot& snapshot)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    constexpr auto renderedMask = static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
+        static_cast<core::EntityMask>(ComponentType::BULLET);
+    const auto size = snapshot.entityMasks.size();
+    Resize(size);
+    const bool isNewFrame = snapshot.frame != currentFrame_;
+    //A new frame restarts the interpolation, a correction of the same frame keeps its progress
+    const float ratio = GetInterpolationRatio();
+    const float newRatio = isNewFrame ? 0.0f : ratio;
+    for (core::Entity entity = 0; entity < size; entity++)
+    {
+        const auto newPosition = snapshot.positions[entity];
+        const auto newRotation = snapshot.rotations[entity];
+        const auto renderedType = snapshot.entityMasks[entity] & renderedMask;
+        //New entity, nothing to interpolate from
+        if (renderedType == 0 || renderedType != (masks_[entity] & renderedMask))
+        {
+            previousPositions_[entity] = newPosition;
+            currentPositions_[entity] = newPosition;
+            positionOffsets_[entity] = {};
+            positionSteps_[entity] = {};
+            previousRotations_[entity] = newRotation;
+            currentRotations_[entity] = newRotation;
+            rotationOffsets_[entity] = core::Degree(0.0f);
+            rotationSteps_[entity] = core::Degree(0.0f);
+            continue;
+        }
+        //Where the entity is drawn right now, a correction continues from there
+        const auto renderedPosition = InterpolatePosition(entity, ratio);
+        const auto renderedRotation = InterpolateRotation(entity, ratio);
+        auto expectedPosition = currentPositions_[entity];
+        auto expectedRotation = currentRotations_[entity];
+        if (isNewFrame)
+        {
+            //Without correction, the new frame should continue the last movement
+            expectedPosition += positionSteps_[entity];
+            expectedRotation += rotationSteps_[entity];
+            previousPositions_[entity] = currentPositions_[entity];
+            previousRotations_[entity] = currentRotations_[entity];
+        }
+        const auto positionErrorMagnitude = (expectedPosition - newPosition).GetMagnitude();
+        const bool isPositionCorrected = positionErrorMagnitude > correctionThreshold;
+        const bool isRotationCorrected = core::Abs(DeltaAngle(newRotation, expectedRotation).value()) > correctionAngleThreshold.value();
+        //The steps of a corrected frame contain the correction, the last uncorrected ones are kept for the extrapolation
+        if (isNewFrame && !isPositionCorrected)
+        {
+            positionSteps_[entity] = newPosition - currentPositions_[entity];
+        }
+        if (isNewFrame && !isRotationCorrected)
+        {
+            rotationSteps_[entity] = DeltaAngle(currentRotations_[entity], newRotation);
+        }
+        currentPositions_[entity] = newPosition;
+        currentRotations_[entity] = newRotation;
+        if (positionErrorMagnitude > teleportThreshold)
+        {
+            previousPositions_[entity] = newPosition;
+            positionOffsets_[entity] = {};
+            positionSteps_[entity] = {};
+        }
+        else if (isPositionCorrected)
+        {
+            positionOffsets_[entity] = renderedPosition - InterpolatePosition(entity, newRatio) + positionOffsets_[entity];
+        }
+        if (isRotationCorrected)
+        {
+            rotationOffsets_[entity] = DeltaAngle(InterpolateRotation(entity, newRatio) - rotationOffsets_[entity], renderedRotation);
+        }
+    }
+    std::copy(snapshot.entityMasks.begin(), snapshot.entityMasks.end(), masks_.begin());
+    if (isNewFrame)
+    {
+        currentFrame_ = snapshot.frame;
+        timer_ = 0.0f;
+    }
+    fixedPeriod_ = snapshot.fixedPeriod;
+}
+
+void RenderInterpolator::Update(float dt)
+{
+    timer_ += dt;
+    const float decay = std::exp(-dt / correctionSmoothingPeriod);
+    for (std::size_t i = 0; i < positionOffsets_.size(); i++)
+    {
+        positionOffsets_[i] = positionOffsets_[i] * decay;
+        rotationOffsets_[i] = rotationOffsets_[i] * decay;
+    }
+}
+
+core::Vec2f RenderInterpolator::GetPosition(core::Entity entity) const
+{
+    if (!isEnabled_)
+    {
+        return currentPositions_[entity];
+    }
+    return InterpolatePosition(entity, GetInterpolationRatio());
+}
+
+core::Degree RenderInterpolator::GetRotation(core::Entity entity) const
+{
+    if (!isEnabled_)
+    {
+        return currentRotations_[entity];
+    }
+    return InterpolateRotation(entity, GetInterpolationRatio());
+}
+
+core::Vec2f RenderInterpolator::InterpolatePosition(core::Entity entity, float ratio) const
+{
+    return core::Vec2f::Lerp(previousPositions_[entity], currentPositions_[entity], ratio) + positionOffsets_[entity];
+}
+
+core::Degree RenderInterpolator::InterpolateRotation(core::Entity entity, float ratio) const
+{
+    return previousRotations_[entity] +
+        DeltaAngle(previousRotations_[entity], currentRotations_[entity]) * ratio +
+        rotationOffsets_[entity];
+}
+
+float RenderInterpolator::GetInterpolationRatio() const
+{
+    return core::Clamp(timer_ / fixedPeriod_, 0.0f, 1.0f);
+}
+
+void RenderInterpolator::Resize(std::size_t size)
+{
+    if (size == masks_.size())
+    {
+        return;
+    }
+    masks_.resize(size, 0);
+    previousPositions_.resize(size);
+    currentPositions_.resize(size);
+    positionOffsets_.resize(size);
+    positionSteps_.resize(size);
+    previousRotations_.resize(size);
+    currentRotations_.resize(size);
+    rotationOffsets_.resize(size);
+    rotationSteps_.resize(size);
+}
+
+core::Degree RenderInterpolator::DeltaAngle(core::Degree a, core::Degree b)
+{
+    float delta = std::fmod(b.value() - a.value() + 180.0f, 360.0f);
+    if (delta < 0.0f)
+    {
+        delta += 360.0f;
+    }
+    return core::Degree(delta - 180.0f);
+}
+}
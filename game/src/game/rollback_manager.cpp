@@ -1,6 +1,8 @@
 #include <game/rollback_manager.h>
 #include <game/game_manager.h>
 #include "utils/assert.h"
+#include <chrono>
+#include <cstring>
 #include <utils/log.h>
 #include <fmt/format.h>
 
@@ -10,14 +12,29 @@
 
 namespace game
 {
+namespace
+{
+/**
+ * \brief AddWords is a function that adds the value, read as PhysicsState words, to the checksum.
+ * The words are copied, reading them through a cast pointer breaks the strict aliasing rule and optimizing compilers drop the reads.
+ */
+template<typename T>
+void AddWords(PhysicsState& state, const T& value)
+{
+    std::array<PhysicsState, sizeof(T) / sizeof(PhysicsState)> words{};
+    std::memcpy(words.data(), &value, sizeof(words));
+    for (const auto word : words)
+    {
+        state += word;
+    }
+}
+}
 
 RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager) :
     gameManager_(gameManager), entityManager_(entityManager),
     currentTransformManager_(entityManager),
     currentPhysicsManager_(entityManager), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
-    currentBulletManager_(entityManager, gameManager),
-    lastValidatePhysicsManager_(entityManager),
-    lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_), lastValidateBulletManager_(entityManager, gameManager)
+    currentBulletManager_(entityManager, gameManager)
 {
     for (auto& input : inputs_)
     {
@@ -26,38 +43,30 @@ RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager&
     currentPhysicsManager_.RegisterTriggerListener(*this);
 }
 
-void RollbackManager::SimulateToCurrentFrame()
+void RollbackManager::SimulateToCurrentFrame(SpeculativeBranch* branch)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    const auto restoreStart = std::chrono::steady_clock::now();
     const auto currentFrame = gameManager_.GetCurrentFrame();
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
+    auto startFrame = gameManager_.GetLastValidateFrame();
+    if (branch != nullptr && branch->frame <= currentFrame && IsBranchValid(*branch))
     {
-        if (createdEntity.createdFrame > lastValidateFrame)
-        {
-            entityManager_.DestroyEntity(createdEntity.entity);
-        }
+        //The branch already simulated the first frames with the same inputs
+        branch->world.Rewind();
+        RestoreWorld(branch->world);
+        startFrame = branch->frame;
     }
-    createdEntities_.clear();
-    //Remove DESTROY flags
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    else
     {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
-        }
+        //Revert the current game state and entities to the last validated game state
+        RestoreValidateWorld();
     }
 
-    //Revert the current game state to the last validated game state
-    currentBulletManager_.CopyAllComponents(lastValidateBulletManager_.GetAllComponents());
-    currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
-    currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
-
-    for (Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
+    const auto simulateStart = std::chrono::steady_clock::now();
+    for (Frame frame = startFrame + 1; frame <= currentFrame; frame++)
     {
         testedFrame_ = frame;
         //Copy player inputs to player manager
@@ -78,18 +87,24 @@ void RollbackManager::SimulateToCurrentFrame()
         currentBulletManager_.FixedUpdate(sf::seconds(fixedPeriod));
         currentPlayerManager_.FixedUpdate(sf::seconds(fixedPeriod));
         currentPhysicsManager_.FixedUpdate(sf::seconds(fixedPeriod));
+        //Remove DESTROY entities at the end of each frame like the validation, so that the predicted frames
+        //give the same numbers to the entities created later
+        for (const auto entity : entityManager_.View<ComponentType::DESTROYED>().ToVector())
+        {
+            entityManager_.DestroyEntity(entity);
+        }
     }
     //Copy the physics states to the transforms
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    for (const auto entity : entityManager_.View<core::ComponentType::BODY2D, core::ComponentType::TRANSFORM>())
     {
-        if (!entityManager_.HasComponent(entity,
-            static_cast<core::EntityMask>(core::ComponentType::BODY2D) |
-            static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
-            continue;
         const auto& body = currentPhysicsManager_.GetBody(entity);
         currentTransformManager_.SetPosition(entity, body.position);
         currentTransformManager_.SetRotation(entity, body.rotation);
     }
+    const auto simulateEnd = std::chrono::steady_clock::now();
+    telemetry_.AddSimulation(currentFrame > startFrame ? currentFrame - startFrame : 0,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(simulateStart - restoreStart).count(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(simulateEnd - simulateStart).count());
 }
 void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, Frame inputFrame)
 {
@@ -98,7 +113,13 @@ void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput play
     {
         StartNewFrame(inputFrame);
     }
+    else if (!receivedInputs_[playerNumber][currentFrame_ - inputFrame] && inputs_[playerNumber][currentFrame_ - inputFrame] != playerInput)
+    {
+        //The frame was already simulated with the repeated input
+        telemetry_.AddMispredictedInput(playerNumber);
+    }
     inputs_[playerNumber][currentFrame_ - inputFrame] = playerInput;
+    receivedInputs_[playerNumber][currentFrame_ - inputFrame] = true;
     if (lastReceivedFrame_[playerNumber] < inputFrame)
     {
         lastReceivedFrame_[playerNumber] = inputFrame;
@@ -135,6 +156,10 @@ void RollbackManager::StartNewFrame(Frame newFrame)
             inputs[i] = inputs[delta];
         }
     }
+    for (auto& receivedInputs : receivedInputs_)
+    {
+        receivedInputs <<= delta;
+    }
     currentFrame_ = newFrame;
 }
 
@@ -144,7 +169,6 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
     //We check that we got all the inputs
     for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
@@ -154,30 +178,8 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
             return;
         }
     }
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
-    {
-        if (createdEntity.createdFrame > lastValidateFrame)
-        {
-            entityManager_.DestroyEntity(createdEntity.entity);
-        }
-    }
-    createdEntities_.clear();
-    //Remove DESTROYED flag
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-    {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
-        }
-
-    }
-    createdEntities_.clear();
-
-    //We use the current game state as the temporary new validate game state
-    currentBulletManager_.CopyAllComponents(lastValidateBulletManager_.GetAllComponents());
-    currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
-    currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+    //We use the current game state and entities as the temporary new validate game state
+    RestoreValidateWorld();
 
     //We simulate the frames until the new validated frame
     for (Frame frame = lastValidateFrame_ + 1; frame <= newValidateFrame; frame++)
@@ -196,21 +198,22 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
         currentBulletManager_.FixedUpdate(sf::seconds(fixedPeriod));
         currentPlayerManager_.FixedUpdate(sf::seconds(fixedPeriod));
         currentPhysicsManager_.FixedUpdate(sf::seconds(fixedPeriod));
-    }
-    //Definitely remove DESTROY entities
-    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-    {
-        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        stateHistory_.Record(frame, entityManager_, currentTransformManager_, currentPhysicsManager_, currentPlayerManager_, currentBulletManager_);
+        //Definitely remove DESTROY entities at the end of each frame, so that the next frames reuse their numbers
+        //the same way whether the frames are validated one by one or all at once
+        for (const auto entity : entityManager_.View<ComponentType::DESTROYED>().ToVector())
         {
             entityManager_.DestroyEntity(entity);
         }
     }
     //Copy back the new validate game state to the last validated game state
-    lastValidateBulletManager_.CopyAllComponents(currentBulletManager_.GetAllComponents());
-    lastValidatePlayerManager_.CopyAllComponents(currentPlayerManager_.GetAllComponents());
-    lastValidatePhysicsManager_.CopyAllComponents(currentPhysicsManager_);
+    SaveValidateWorld();
+    telemetry_.AddValidation(currentFrame_ > newValidateFrame ? currentFrame_ - newValidateFrame : 0);
+    if (newValidateFrame / telemetryDumpPeriod > lastValidateFrame_ / telemetryDumpPeriod)
+    {
+        core::LogDebug(telemetry_.ToString());
+    }
     lastValidateFrame_ = newValidateFrame;
-    createdEntities_.clear();
 }
 void RollbackManager::ConfirmFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState)
 {
@@ -224,6 +227,15 @@ void RollbackManager::ConfirmFrame(Frame newValidateFrame, const std::array<Phys
         const PhysicsState lastPhysicsState = GetValidatePhysicsState(playerNumber);
         if (serverPhysicsState[playerNumber] != lastPhysicsState)
         {
+            if (!desyncDumpPath_.empty())
+            {
+                const auto dumpPath = fmt::format("{}_{}.hash", desyncDumpPath_, newValidateFrame);
+                if (stateHistory_.Dump(dumpPath))
+                {
+                    core::LogError(fmt::format("Desync at frame {}, the state history is dumped in {}", newValidateFrame, dumpPath));
+                }
+                desyncDumpPath_.clear();
+            }
             gpr_assert(false, fmt::format("Physics State are not equal for player {} (server frame: {}, client frame: {}, server: {}, client: {})", 
                 playerNumber+1, 
                 newValidateFrame, 
@@ -236,42 +248,20 @@ void RollbackManager::ConfirmFrame(Frame newValidateFrame, const std::array<Phys
 PhysicsState RollbackManager::GetValidatePhysicsState(PlayerNumber playerNumber) const
 {
     PhysicsState state = 0;
-    const core::Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-    const auto& playerBody = lastValidatePhysicsManager_.GetBody(playerEntity);
+    const auto& playerBody = lastValidatePlayerBodies_[playerNumber];
 
-    const auto pos = playerBody.position;
-    const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
     //Adding position
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
-    {
-        state += posPtr[i];
-    }
-
+    AddWords(state, playerBody.position);
     //Adding velocity
-    const auto velocity = playerBody.velocity;
-    const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
-    {
-        state += velocityPtr[i];
-    }
+    AddWords(state, playerBody.velocity);
     //Adding rotation
-    const auto angle = playerBody.rotation.value();
-    const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += anglePtr[i];
-    }
+    AddWords(state, playerBody.rotation.value());
     //Adding angular Velocity
-    const auto angularVelocity = playerBody.angularVelocity.value();
-    const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += angularVelPtr[i];
-    }
+    AddWords(state, playerBody.angularVelocity.value());
     return state;
 }
 
-void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Degree rotation)
+core::Entity RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Degree rotation)
 {
 
 #ifdef TRACY_ENABLE
@@ -286,6 +276,9 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     PlayerCharacter playerCharacter;
     playerCharacter.playerNumber = playerNumber;
 
+    //The player is added to the validated world, the current world is resimulated from it anyway
+    RestoreValidateWorld();
+    const auto entity = entityManager_.CreateEntity();
     currentPlayerManager_.AddComponent(entity);
     currentPlayerManager_.SetComponent(entity, playerCharacter);
 
@@ -294,17 +287,163 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     currentPhysicsManager_.AddBox(entity);
     currentPhysicsManager_.SetBox(entity, playerBox);
 
-    lastValidatePlayerManager_.AddComponent(entity);
-    lastValidatePlayerManager_.SetComponent(entity, playerCharacter);
-
-    lastValidatePhysicsManager_.AddBody(entity);
-    lastValidatePhysicsManager_.SetBody(entity, playerBody);
-    lastValidatePhysicsManager_.AddBox(entity);
-    lastValidatePhysicsManager_.SetBox(entity, playerBox);
-
     currentTransformManager_.AddComponent(entity);
     currentTransformManager_.SetPosition(entity, position);
     currentTransformManager_.SetRotation(entity, rotation);
+    SaveValidateWorld();
+    lastValidatePlayerBodies_[playerNumber] = playerBody;
+    return entity;
+}
+
+void RollbackManager::SaveWorld(core::SnapshotArena& arena) const
+{
+    entityManager_.SaveEntities(arena);
+    currentTransformManager_.SaveComponents(arena);
+    currentPhysicsManager_.SaveComponents(arena);
+    currentPlayerManager_.SaveComponents(arena);
+    currentBulletManager_.SaveComponents(arena);
+}
+
+void RollbackManager::RestoreWorld(core::SnapshotArena& arena)
+{
+    entityManager_.RestoreEntities(arena);
+    currentTransformManager_.RestoreComponents(arena);
+    currentPhysicsManager_.RestoreComponents(arena);
+    currentPlayerManager_.RestoreComponents(arena);
+    currentBulletManager_.RestoreComponents(arena);
+}
+
+void RollbackManager::SaveValidateWorld()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    lastValidateWorld_.Clear();
+    SaveWorld(lastValidateWorld_);
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
+        if (playerEntity == core::INVALID_ENTITY ||
+            !entityManager_.HasComponent(playerEntity, static_cast<core::EntityMask>(core::ComponentType::BODY2D)))
+        {
+            continue;
+        }
+        lastValidatePlayerBodies_[playerNumber] = currentPhysicsManager_.GetBody(playerEntity);
+    }
+}
+
+void RollbackManager::RestoreValidateWorld()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //Nothing was validated yet, the current world is still the initial one
+    if (lastValidateWorld_.GetSize() == 0)
+    {
+        return;
+    }
+    lastValidateWorld_.Rewind();
+    RestoreWorld(lastValidateWorld_);
+    gpr_assert(!lastValidateWorld_.HasReadError() && lastValidateWorld_.IsAtEnd(), "Validated world snapshot was not entirely restored");
+}
+
+void RollbackManager::SaveRollbackState(RollbackState& rollbackState) const
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    rollbackState.lastValidateWorld.CopyAll(lastValidateWorld_);
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        rollbackState.playerEntities[playerNumber] = gameManager_.GetEntityFromPlayerNumber(playerNumber);
+    }
+    rollbackState.inputs = inputs_;
+    rollbackState.lastReceivedFrame = lastReceivedFrame_;
+    rollbackState.lastValidateFrame = lastValidateFrame_;
+    rollbackState.currentFrame = currentFrame_;
+}
+
+void RollbackManager::LoadRollbackState(const RollbackState& rollbackState)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    lastValidateWorld_.CopyAll(rollbackState.lastValidateWorld);
+    inputs_ = rollbackState.inputs;
+    lastReceivedFrame_ = rollbackState.lastReceivedFrame;
+    lastValidateFrame_ = rollbackState.lastValidateFrame;
+    currentFrame_ = rollbackState.currentFrame;
+}
+
+bool RollbackManager::CheckRollbackState(const RollbackState& rollbackState)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    core::SnapshotArena currentWorld;
+    SaveWorld(currentWorld);
+    core::SnapshotArena world;
+    world.CopyAll(rollbackState.lastValidateWorld);
+    RestoreWorld(world);
+    bool isValid = !world.HasReadError() && world.IsAtEnd();
+    for (const auto playerEntity : rollbackState.playerEntities)
+    {
+        isValid = isValid && playerEntity < entityManager_.GetEntitiesSize() &&
+            entityManager_.HasComponent(playerEntity,
+                static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) | static_cast<core::EntityMask>(core::ComponentType::BODY2D));
+    }
+    //The checked world is only restored to be read, the current world is put back
+    RestoreWorld(currentWorld);
+    return isValid;
+}
+
+void RollbackManager::SetPredictedInput(PlayerNumber playerNumber, PlayerInput playerInput)
+{
+    if (lastReceivedFrame_[playerNumber] >= currentFrame_)
+    {
+        return;
+    }
+    for (Frame i = 0; i < currentFrame_ - lastReceivedFrame_[playerNumber] && i < windowBufferSize; i++)
+    {
+        inputs_[playerNumber][i] = playerInput;
+    }
+}
+
+void RollbackManager::SaveSpeculativeBranch(SpeculativeBranch& branch) const
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    branch.world.Clear();
+    SaveWorld(branch.world);
+    branch.inputs = inputs_;
+    branch.lastValidateFrame = lastValidateFrame_;
+    branch.frame = currentFrame_;
+}
+
+bool RollbackManager::IsBranchValid(const SpeculativeBranch& branch) const
+{
+    if (branch.lastValidateFrame != lastValidateFrame_ || branch.frame <= lastValidateFrame_ || branch.frame > currentFrame_)
+    {
+        return false;
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        for (Frame frame = lastValidateFrame_ + 1; frame <= branch.frame; frame++)
+        {
+            if (branch.inputs[playerNumber][branch.frame - frame] != GetInputAtFrame(playerNumber, frame))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 PlayerInput RollbackManager::GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const
@@ -352,8 +491,6 @@ void RollbackManager::OnTrigger(core::Entity entity1, core::Entity entity2)
 
 void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity)
 {
-    createdEntities_.push_back({ entity, testedFrame_ });
-
     Body bulletBody;
     bulletBody.position = position;
     bulletBody.velocity = velocity;
@@ -374,21 +511,24 @@ void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity
     currentTransformManager_.SetRotation(entity, core::Degree(0.0f));
 }
 
+core::Entity RollbackManager::SpawnValidatedBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity)
+{
+    //The bullet is added to the validated world, the current world is resimulated from it anyway
+    RestoreValidateWorld();
+    const auto entity = entityManager_.CreateEntity();
+    SpawnBullet(playerNumber, entity, position, velocity);
+    SaveValidateWorld();
+    return entity;
+}
+
 void RollbackManager::DestroyEntity(core::Entity entity)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    //we don't need to save a bullet that has been created in the time window
-    if (std::find_if(createdEntities_.begin(), createdEntities_.end(), [entity](auto newEntity)
-        {
-            return newEntity.entity == entity;
-        }) != createdEntities_.end())
-    {
-        entityManager_.DestroyEntity(entity);
-        return;
-    }
-        entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+    //The entity is still iterated by the systems of the simulated frame, it is destroyed at validation
+    //or disappears when restoring the validated entities
+    entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
 }
 }
@@ -0,0 +1,57 @@
+#include "game/rollback_telemetry.h"
+
+#include <fmt/format.h>
+
+namespace game
+{
+void RollbackTelemetry::AddSimulation(Frame resimulatedFrames, std::uint64_t restoreTime, std::uint64_t simulateTime)
+{
+    resimulatedFrames_.Add(resimulatedFrames);
+    restoreTime_.Add(restoreTime);
+    simulateTime_.Add(simulateTime);
+}
+
+void RollbackTelemetry::AddMispredictedInput(PlayerNumber playerNumber)
+{
+    mispredictedInputs_[playerNumber].fetch_add(1, std::memory_order_relaxed);
+}
+
+void RollbackTelemetry::AddValidation(Frame validationLag)
+{
+    validationLag_.Add(validationLag);
+}
+
+void RollbackTelemetry::Reset()
+{
+    resimulatedFrames_.Reset();
+    restoreTime_.Reset();
+    simulateTime_.Reset();
+    validationLag_.Reset();
+    for (auto& mispredictedInputs : mispredictedInputs_)
+    {
+        mispredictedInputs.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string RollbackTelemetry::ToString() const
+{
+    std::string mispredictedInputs;
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        mispredictedInputs += fmt::format("{}{}", playerNumber == 0 ? "" : "/", GetMispredictedInputs(playerNumber));
+    }
+    return fmt::format("[Rollback] updates: {} resimulated frames mean: {:.2f} p95: <{} max: {} | "
+        "restore mean: {:.1f}us simulate mean: {:.1f}us p95: <{:.1f}us | "
+        "mispredicted inputs: {} | validation lag mean: {:.2f} max: {}",
+        resimulatedFrames_.GetCount(),
+        resimulatedFrames_.GetMean(),
+        resimulatedFrames_.GetPercentile(0.95),
+        resimulatedFrames_.GetMax(),
+        restoreTime_.GetMean() / 1000.0,
+        simulateTime_.GetMean() / 1000.0,
+        static_cast<double>(simulateTime_.GetPercentile(0.95)) / 1000.0,
+        mispredictedInputs,
+        validationLag_.GetMean(),
+        validationLag_.GetMax());
+}
+}
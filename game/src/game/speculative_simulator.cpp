@@ -0,0 +1,188 @@
+#include "game/speculative_simulator.h"
+
+#include <algorithm>
+
+#include "game/game_manager.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+/**
+ * \brief SpeculativeGameManager is the private world of a speculation worker, it resimulates a copy of the rollback state.
+ */
+class SpeculativeGameManager final : public GameManager
+{
+public:
+    void Simulate(const RollbackState& rollbackState, PlayerNumber playerNumber, PlayerInput playerInput, SpeculativeBranch& branch)
+    {
+
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        playerEntityMap_ = rollbackState.playerEntities;
+        currentFrame_ = rollbackState.currentFrame;
+        rollbackManager_.LoadRollbackState(rollbackState);
+        rollbackManager_.SetPredictedInput(playerNumber, playerInput);
+        rollbackManager_.SimulateToCurrentFrame();
+        rollbackManager_.SaveSpeculativeBranch(branch);
+    }
+};
+}
+
+SpeculativeSimulator::~SpeculativeSimulator()
+{
+    Stop();
+}
+
+bool SpeculativeSimulator::Start(std::size_t branchCount)
+{
+    const std::size_t coreCount = std::thread::hardware_concurrency();
+    //One core is kept for the rendering and one for the simulation
+    const std::size_t spareCoreCount = coreCount > 2 ? coreCount - 2 : 0;
+    branchCount_ = std::min(branchCount, speculativeInputToggles.size());
+    const auto workerCount = std::min(branchCount_, spareCoreCount);
+    if (workerCount == 0)
+    {
+        core::LogWarning(fmt::format("No spare core for the speculative simulation ({} cores)", coreCount));
+        return false;
+    }
+    isRunning_ = true;
+    for (std::size_t i = 0; i < workerCount; i++)
+    {
+        workers_.emplace_back(&SpeculativeSimulator::WorkerLoop, this);
+    }
+    return true;
+}
+
+void SpeculativeSimulator::Stop()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        isRunning_ = false;
+    }
+    jobCondition_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+    jobs_.clear();
+    branches_.clear();
+}
+
+void SpeculativeSimulator::Speculate(const RollbackManager& rollbackManager, PlayerNumber localPlayer)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!IsRunning())
+    {
+        return;
+    }
+    auto rollbackState = std::make_shared<RollbackState>();
+    rollbackManager.SaveRollbackState(*rollbackState);
+    const auto currentFrame = rollbackState->currentFrame;
+
+    std::scoped_lock lock(mutex_);
+    //The pending jobs of the previous frame are outdated
+    jobs_.clear();
+    std::erase_if(branches_, [&rollbackManager](const auto& branch)
+    {
+        return branch->lastValidateFrame != rollbackManager.GetLastValidateFrame();
+    });
+    if (branches_.size() > maxSpeculativeBranchNmb)
+    {
+        std::sort(branches_.begin(), branches_.end(), [](const auto& branch1, const auto& branch2)
+        {
+            return branch1->frame > branch2->frame;
+        });
+        branches_.resize(maxSpeculativeBranchNmb);
+    }
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        const auto lastReceivedFrame = rollbackState->lastReceivedFrame[playerNumber];
+        if (playerNumber == localPlayer ||
+            rollbackState->playerEntities[playerNumber] == core::INVALID_ENTITY ||
+            lastReceivedFrame >= currentFrame ||
+            currentFrame - lastReceivedFrame >= windowBufferSize)
+        {
+            continue;
+        }
+        //The prediction repeats the last received input, the branches diverge from it
+        const auto lastInput = rollbackState->inputs[playerNumber][currentFrame - lastReceivedFrame];
+        for (std::size_t i = 0; i < branchCount_; i++)
+        {
+            jobs_.push_back({ rollbackState, playerNumber, static_cast<PlayerInput>(lastInput ^ speculativeInputToggles[i]) });
+        }
+    }
+    jobCondition_.notify_all();
+}
+
+SpeculativeBranch* SpeculativeSimulator::FindBranch(const RollbackManager& rollbackManager)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!IsRunning())
+    {
+        return nullptr;
+    }
+    std::scoped_lock lock(mutex_);
+    SpeculativeBranch* bestBranch = nullptr;
+    for (auto& branch : branches_)
+    {
+        if ((bestBranch == nullptr || branch->frame > bestBranch->frame) && rollbackManager.IsBranchValid(*branch))
+        {
+            bestBranch = branch.get();
+        }
+    }
+    if (bestBranch != nullptr)
+    {
+        adoptedBranchCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return bestBranch;
+}
+
+void SpeculativeSimulator::WorkerLoop()
+{
+#ifdef TRACY_ENABLE
+    tracy::SetThreadName("Speculation");
+#endif
+    SpeculativeGameManager gameManager;
+    try
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex_);
+                jobCondition_.wait(lock, [this] { return !isRunning_ || !jobs_.empty(); });
+                if (!isRunning_)
+                {
+                    return;
+                }
+                job = std::move(jobs_.back());
+                jobs_.pop_back();
+            }
+            auto branch = std::make_unique<SpeculativeBranch>();
+            gameManager.Simulate(*job.rollbackState, job.playerNumber, job.playerInput, *branch);
+            std::scoped_lock lock(mutex_);
+            branches_.push_back(std::move(branch));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        core::LogError(fmt::format("Speculation worker stopped: {}", e.what()));
+    }
+}
+}
@@ -0,0 +1,564 @@
+#include "game/state_history.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+
+#include "game/bullet_manager.h"
+#include "game/physics_manager.h"
+#include "game/player_character.h"
+#include "engine/transform.h"
+#include "utils/assert.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+enum class FieldType
+{
+    MASK,
+    INTEGER,
+    FLOAT
+};
+
+struct StateField
+{
+    std::string_view name;
+    FieldType type;
+};
+
+constexpr std::array<StateField, 1> entityFields{ { { "mask", FieldType::MASK } } };
+constexpr std::array<StateField, 2> vectorFields{ { { "x", FieldType::FLOAT }, { "y", FieldType::FLOAT } } };
+constexpr std::array<StateField, 1> rotationFields{ { { "value", FieldType::FLOAT } } };
+constexpr std::array<StateField, 7> bodyFields
+{ {
+    { "position.x", FieldType::FLOAT },
+    { "position.y", FieldType::FLOAT },
+    { "velocity.x", FieldType::FLOAT },
+    { "velocity.y", FieldType::FLOAT },
+    { "angularVelocity", FieldType::FLOAT },
+    { "rotation", FieldType::FLOAT },
+    { "bodyType", FieldType::INTEGER },
+} };
+constexpr std::array<StateField, 3> boxFields
+{ {
+    { "extends.x", FieldType::FLOAT },
+    { "extends.y", FieldType::FLOAT },
+    { "isTrigger", FieldType::INTEGER },
+} };
+constexpr std::array<StateField, 5> playerCharacterFields
+{ {
+    { "shootingTime", FieldType::FLOAT },
+    { "input", FieldType::MASK },
+    { "playerNumber", FieldType::INTEGER },
+    { "health", FieldType::INTEGER },
+    { "invincibilityTime", FieldType::FLOAT },
+} };
+constexpr std::array<StateField, 2> bulletFields
+{ {
+    { "remainingTime", FieldType::FLOAT },
+    { "playerNumber", FieldType::INTEGER },
+} };
+
+/**
+ * \brief GetFields is a function that returns the fields of a component, in the order of the recorded values.
+ */
+std::span<const StateField> GetFields(StateComponent component)
+{
+    switch (component)
+    {
+    case StateComponent::ENTITY: return entityFields;
+    case StateComponent::POSITION: return vectorFields;
+    case StateComponent::SCALE: return vectorFields;
+    case StateComponent::ROTATION: return rotationFields;
+    case StateComponent::BODY: return bodyFields;
+    case StateComponent::BOX: return boxFields;
+    case StateComponent::PLAYER_CHARACTER: return playerCharacterFields;
+    case StateComponent::BULLET: return bulletFields;
+    default: return {};
+    }
+}
+
+/**
+ * \brief componentMasks are the entity mask bits of each StateComponent, the ENTITY one is recorded for every entity.
+ */
+constexpr std::array<core::EntityMask, stateComponentNmb> componentMasks
+{
+    core::INVALID_ENTITY_MASK,
+    static_cast<core::EntityMask>(core::ComponentType::POSITION),
+    static_cast<core::EntityMask>(core::ComponentType::SCALE),
+    static_cast<core::EntityMask>(core::ComponentType::ROTATION),
+    static_cast<core::EntityMask>(core::ComponentType::BODY2D),
+    static_cast<core::EntityMask>(core::ComponentType::BOX_COLLIDER2D),
+    static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER),
+    static_cast<core::EntityMask>(ComponentType::BULLET),
+};
+
+bool HasStateComponent(core::EntityMask mask, std::size_t component)
+{
+    return component == 0 || (mask & componentMasks[component]) == componentMasks[component];
+}
+
+constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+/**
+ * \brief HashWord is a function that adds a 32 bits word to a FNV-1a hash.
+ * The whole word is mixed at once instead of byte after byte, a frame is hashed on every validation.
+ */
+void HashWord(std::uint64_t& hash, std::uint32_t word)
+{
+    hash ^= word;
+    hash *= fnvPrime;
+}
+
+std::uint32_t ToWord(float value)
+{
+    return std::bit_cast<std::uint32_t>(value);
+}
+
+/**
+ * \brief EntityValues are the offsets of the components of one entity in the values of a FrameState, npos if the entity does not have it.
+ */
+struct EntityValues
+{
+    core::Entity entity = core::INVALID_ENTITY;
+    std::array<std::size_t, stateComponentNmb> offsets{};
+};
+constexpr auto npos = static_cast<std::size_t>(-1);
+
+std::vector<EntityValues> DecodeEntities(const FrameState& frameState)
+{
+    std::vector<EntityValues> entities;
+    const auto& values = frameState.values;
+    std::size_t offset = 0;
+    while (offset + 2 <= values.size())
+    {
+        auto& entityValues = entities.emplace_back();
+        entityValues.entity = values[offset];
+        const auto mask = values[offset + 1];
+        offset++;
+        for (std::size_t component = 0; component < stateComponentNmb; component++)
+        {
+            if (!HasStateComponent(mask, component))
+            {
+                entityValues.offsets[component] = npos;
+                continue;
+            }
+            entityValues.offsets[component] = offset;
+            offset += GetFields(static_cast<StateComponent>(component)).size();
+        }
+        if (offset > values.size())
+        {
+            //The values of a dump from another version of the game
+            entities.pop_back();
+            break;
+        }
+    }
+    return entities;
+}
+
+/**
+ * \brief ComponentRecord is the values of one component of one entity in a FrameState.
+ */
+struct ComponentRecord
+{
+    core::Entity entity = core::INVALID_ENTITY;
+    const std::uint32_t* values = nullptr;
+};
+
+std::vector<ComponentRecord> GetComponentRecords(const FrameState& frameState, const std::vector<EntityValues>& entities, std::size_t component)
+{
+    std::vector<ComponentRecord> records;
+    for (const auto& entityValues : entities)
+    {
+        if (entityValues.offsets[component] != npos)
+        {
+            records.push_back({ entityValues.entity, frameState.values.data() + entityValues.offsets[component] });
+        }
+    }
+    return records;
+}
+
+/**
+ * \brief CompareComponent is a function that compares the records of the same entity numbers, both sorted by entity,
+ * and returns the first field of the first entity whose record differs or is only in one frame.
+ */
+std::optional<StateDivergence> CompareComponent(const std::vector<ComponentRecord>& records1, const std::vector<ComponentRecord>& records2,
+    std::size_t fieldNmb)
+{
+    auto it1 = records1.begin();
+    auto it2 = records2.begin();
+    while (it1 != records1.end() || it2 != records2.end())
+    {
+        StateDivergence divergence;
+        if (it2 == records2.end() || (it1 != records1.end() && it1->entity < it2->entity))
+        {
+            divergence.entity1 = it1->entity;
+            divergence.value1 = it1->values[0];
+            return divergence;
+        }
+        if (it1 == records1.end() || it2->entity < it1->entity)
+        {
+            divergence.entity2 = it2->entity;
+            divergence.value2 = it2->values[0];
+            return divergence;
+        }
+        const auto [field1, field2] = std::mismatch(it1->values, it1->values + fieldNmb, it2->values);
+        if (field1 != it1->values + fieldNmb)
+        {
+            divergence.entity1 = it1->entity;
+            divergence.entity2 = it2->entity;
+            divergence.field = static_cast<std::size_t>(field1 - it1->values);
+            divergence.value1 = *field1;
+            divergence.value2 = *field2;
+            return divergence;
+        }
+        ++it1;
+        ++it2;
+    }
+    return std::nullopt;
+}
+
+/**
+ * \brief CompareFrames is a function that looks for the first differing field of two frames with different hashes.
+ */
+StateDivergence CompareFrames(const FrameState& frameState1, const FrameState& frameState2)
+{
+    const auto entities1 = DecodeEntities(frameState1);
+    const auto entities2 = DecodeEntities(frameState2);
+    std::optional<StateDivergence> divergence;
+    for (std::size_t component = 0; component < stateComponentNmb && !divergence.has_value(); component++)
+    {
+        if (frameState1.hashes[component] == frameState2.hashes[component])
+        {
+            continue;
+        }
+        const auto records1 = GetComponentRecords(frameState1, entities1, component);
+        const auto records2 = GetComponentRecords(frameState2, entities2, component);
+        divergence = CompareComponent(records1, records2, GetFields(static_cast<StateComponent>(component)).size());
+        if (!divergence.has_value())
+        {
+            //Only the hashes differ
+            divergence = StateDivergence{};
+        }
+        divergence->component = static_cast<StateComponent>(component);
+    }
+    divergence->frame = frameState1.frame;
+    return *divergence;
+}
+
+std::string FormatValue(const std::optional<std::uint32_t>& value, FieldType type)
+{
+    if (!value.has_value())
+    {
+        return "missing";
+    }
+    switch (type)
+    {
+    case FieldType::MASK: return fmt::format("{:#x}", *value);
+    case FieldType::FLOAT: return fmt::format("{} ({:#010x})", std::bit_cast<float>(*value), *value);
+    default: return fmt::format("{}", static_cast<std::int32_t>(*value));
+    }
+}
+
+template<typename T>
+void Write(std::ofstream& file, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Dumps are copied as raw memory");
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool Read(std::ifstream& file, T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Dumps are copied as raw memory");
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+StateHistory::StateHistory() : frames_(stateHistorySize)
+{
+}
+
+void StateHistory::Record(Frame frame, const core::EntityManager& entityManager, const core::TransformManager& transformManager,
+    const PhysicsManager& physicsManager, const PlayerCharacterManager& playerCharacterManager, const BulletManager& bulletManager)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (size_ > 0 && GetFrameState(size_ - 1).frame + 1 != frame)
+    {
+        Clear();
+    }
+    std::size_t index = (first_ + size_) % frames_.size();
+    if (size_ < frames_.size())
+    {
+        size_++;
+    }
+    else
+    {
+        //The oldest frame is overwritten
+        index = first_;
+        first_ = (first_ + 1) % frames_.size();
+    }
+    auto& frameState = frames_[index];
+    frameState.frame = frame;
+    frameState.hashes.fill(fnvOffsetBasis);
+    frameState.values.clear();
+
+    const auto& entityMasks = entityManager.GetAllEntityMasks();
+    for (core::Entity entity = 0; entity < entityMasks.size(); entity++)
+    {
+        const auto mask = entityMasks[entity];
+        if (mask == core::INVALID_ENTITY_MASK || (mask & static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        {
+            continue;
+        }
+        //The entities are hashed in the order of their numbers, each component hash chains the entity number then its fields
+        const auto addValues = [&frameState, entity](StateComponent component, std::initializer_list<std::uint32_t> values)
+        {
+            gpr_assert(values.size() == GetFields(component).size(), "The recorded values need to match the component fields");
+            auto& hash = frameState.hashes[static_cast<std::size_t>(component)];
+            HashWord(hash, entity);
+            for (const auto value : values)
+            {
+                HashWord(hash, value);
+            }
+            frameState.values.insert(frameState.values.end(), values);
+        };
+        frameState.values.push_back(entity);
+        addValues(StateComponent::ENTITY, { mask });
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::POSITION)))
+        {
+            const auto position = transformManager.GetPosition(entity);
+            addValues(StateComponent::POSITION, { ToWord(position.x), ToWord(position.y) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::SCALE)))
+        {
+            const auto scale = transformManager.GetScale(entity);
+            addValues(StateComponent::SCALE, { ToWord(scale.x), ToWord(scale.y) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::ROTATION)))
+        {
+            addValues(StateComponent::ROTATION, { ToWord(transformManager.GetRotation(entity).value()) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::BODY)))
+        {
+            const auto& body = physicsManager.GetBody(entity);
+            addValues(StateComponent::BODY, {
+                ToWord(body.position.x), ToWord(body.position.y),
+                ToWord(body.velocity.x), ToWord(body.velocity.y),
+                ToWord(body.angularVelocity.value()), ToWord(body.rotation.value()),
+                static_cast<std::uint32_t>(body.bodyType) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::BOX)))
+        {
+            const auto& box = physicsManager.GetBox(entity);
+            addValues(StateComponent::BOX, {
+                ToWord(box.extends.x), ToWord(box.extends.y), static_cast<std::uint32_t>(box.isTrigger) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::PLAYER_CHARACTER)))
+        {
+            const auto& playerCharacter = playerCharacterManager.GetComponent(entity);
+            addValues(StateComponent::PLAYER_CHARACTER, {
+                ToWord(playerCharacter.shootingTime),
+                playerCharacter.input,
+                playerCharacter.playerNumber,
+                static_cast<std::uint32_t>(playerCharacter.health),
+                ToWord(playerCharacter.invincibilityTime) });
+        }
+        if (HasStateComponent(mask, static_cast<std::size_t>(StateComponent::BULLET)))
+        {
+            const auto& bullet = bulletManager.GetComponent(entity);
+            addValues(StateComponent::BULLET, { ToWord(bullet.remainingTime), bullet.playerNumber });
+        }
+    }
+}
+
+void StateHistory::Clear()
+{
+    first_ = 0;
+    size_ = 0;
+}
+
+const FrameState& StateHistory::GetFrameState(std::size_t index) const
+{
+    gpr_assert(index < size_, "The frame state needs to be recorded");
+    return frames_[(first_ + index) % frames_.size()];
+}
+
+const FrameState* StateHistory::FindFrameState(Frame frame) const
+{
+    //The recorded frames follow each other
+    if (size_ == 0 || frame < GetFrameState(0).frame || frame - GetFrameState(0).frame >= size_)
+    {
+        return nullptr;
+    }
+    return &GetFrameState(frame - GetFrameState(0).frame);
+}
+
+bool StateHistory::Dump(std::string_view path) const
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        core::LogError(fmt::format("Could not create the state history dump {}", path));
+        return false;
+    }
+    Write(file, stateHistoryMagic);
+    Write(file, stateHistoryVersion);
+    Write(file, static_cast<std::uint8_t>(stateComponentNmb));
+    Write(file, static_cast<std::uint32_t>(size_));
+    for (std::size_t i = 0; i < size_; i++)
+    {
+        const auto& frameState = GetFrameState(i);
+        Write(file, frameState.frame);
+        Write(file, frameState.hashes);
+        Write(file, static_cast<std::uint32_t>(frameState.values.size()));
+        file.write(reinterpret_cast<const char*>(frameState.values.data()),
+            static_cast<std::streamsize>(frameState.values.size() * sizeof(std::uint32_t)));
+    }
+    return static_cast<bool>(file);
+}
+
+bool StateHistory::Load(std::string_view path)
+{
+    Clear();
+    std::ifstream file(std::string(path), std::ios::binary);
+    if (!file)
+    {
+        core::LogError(fmt::format("Could not open the state history dump {}", path));
+        return false;
+    }
+    std::array<char, 4> magic{};
+    std::uint16_t version = 0;
+    std::uint8_t componentNmb = 0;
+    std::uint32_t frameNmb = 0;
+    if (!Read(file, magic) || !Read(file, version) || !Read(file, componentNmb) || !Read(file, frameNmb) ||
+        magic != stateHistoryMagic || version != stateHistoryVersion || componentNmb != stateComponentNmb)
+    {
+        core::LogError(fmt::format("State history dump {} was not written by this version of the game", path));
+        return false;
+    }
+    frames_.resize(std::max<std::size_t>(frames_.size(), frameNmb));
+    for (std::uint32_t i = 0; i < frameNmb; i++)
+    {
+        auto& frameState = frames_[i];
+        std::uint32_t valueNmb = 0;
+        if (!Read(file, frameState.frame) || !Read(file, frameState.hashes) || !Read(file, valueNmb))
+        {
+            break;
+        }
+        frameState.values.resize(valueNmb);
+        if (!file.read(reinterpret_cast<char*>(frameState.values.data()),
+            static_cast<std::streamsize>(valueNmb * sizeof(std::uint32_t))))
+        {
+            break;
+        }
+        size_++;
+    }
+    if (size_ != frameNmb)
+    {
+        core::LogWarning(fmt::format("State history dump {} is truncated, {} frames of {} are loaded", path, size_, frameNmb));
+    }
+    return true;
+}
+
+std::optional<StateDivergence> FindDivergence(const StateHistory& history1, const StateHistory& history2)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    bool isFirstComparedFrame = true;
+    for (std::size_t i = 0; i < history1.GetSize(); i++)
+    {
+        const auto& frameState1 = history1.GetFrameState(i);
+        const auto* frameState2 = history2.FindFrameState(frameState1.frame);
+        if (frameState2 == nullptr)
+        {
+            continue;
+        }
+        if (frameState1.hashes != frameState2->hashes)
+        {
+            auto divergence = CompareFrames(frameState1, *frameState2);
+            divergence.isFirstComparedFrame = isFirstComparedFrame;
+            return divergence;
+        }
+        isFirstComparedFrame = false;
+    }
+    return std::nullopt;
+}
+
+std::uint64_t ComputeStateHash(const FrameState& frameState)
+{
+    auto hash = fnvOffsetBasis;
+    for (const auto componentHash : frameState.hashes)
+    {
+        HashWord(hash, static_cast<std::uint32_t>(componentHash));
+        HashWord(hash, static_cast<std::uint32_t>(componentHash >> 32u));
+    }
+    return hash;
+}
+
+std::string_view GetStateComponentName(StateComponent component)
+{
+    switch (component)
+    {
+    case StateComponent::ENTITY: return "Entity";
+    case StateComponent::POSITION: return "Position";
+    case StateComponent::SCALE: return "Scale";
+    case StateComponent::ROTATION: return "Rotation";
+    case StateComponent::BODY: return "Body";
+    case StateComponent::BOX: return "Box";
+    case StateComponent::PLAYER_CHARACTER: return "PlayerCharacter";
+    case StateComponent::BULLET: return "Bullet";
+    default: return "Unknown";
+    }
+}
+
+std::string ToString(const StateDivergence& divergence)
+{
+    if (divergence.entity1 == core::INVALID_ENTITY && divergence.entity2 == core::INVALID_ENTITY)
+    {
+        return fmt::format("frame {}: the {} hashes differ", divergence.frame, GetStateComponentName(divergence.component));
+    }
+    std::string entity;
+    if (divergence.entity2 == core::INVALID_ENTITY)
+    {
+        entity = fmt::format("entity {} of the first history", divergence.entity1);
+    }
+    else if (divergence.entity1 == core::INVALID_ENTITY)
+    {
+        entity = fmt::format("entity {} of the second history", divergence.entity2);
+    }
+    else
+    {
+        entity = fmt::format("entity {}", divergence.entity1);
+    }
+    const auto& field = GetFields(divergence.component)[divergence.field];
+    return fmt::format("frame {}: {} {}.{} differs: {} != {}",
+        divergence.frame,
+        entity,
+        GetStateComponentName(divergence.component),
+        field.name,
+        FormatValue(divergence.value1, field.type),
+        FormatValue(divergence.value2, field.type));
+}
+}
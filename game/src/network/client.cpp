@@ -4,6 +4,10 @@
 #include "utils/assert.h"
 #include "utils/conversion.h"
 
+#include <algorithm>
+#include <cmath>
+#include <imgui.h>
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
@@ -39,12 +43,14 @@ void Client::ReceivePacket(const Packet* packet)
     case PacketType::START_GAME:
     {
         core::LogDebug("Start Game Packet Received");
-        using namespace std::chrono;
-        const auto startingTime = (duration_cast<duration<long long, std::milli>>(
-            system_clock::now().time_since_epoch()
-            ) + milliseconds(startDelay)).count() - milliseconds(static_cast<long long>(currentPing_)).count();
-
-        gameManager_.StartGame(startingTime);
+        const auto* startGamePacket = static_cast<const StartGamePacket*>(packet);
+        const auto serverStartTime = core::ConvertFromBinary<long long>(startGamePacket->startTime);
+        //Without any ping answered yet, the packet is assumed to have taken half the round trip time
+        const auto startingTime = clockSync_.HasEstimate() ?
+            clockSync_.ToLocalTime(serverStartTime) :
+            GetClockTime() + startDelay - static_cast<long long>(currentPing_ / 2.0f);
+
+        gameManager_.StartGame(static_cast<unsigned long long>(startingTime));
         break;
     }
     case PacketType::INPUT:
@@ -117,19 +123,31 @@ void Client::ReceivePacket(const Packet* packet)
         gameManager_.WinGame(winGamePacket->winner);
         break;
     }
+    case PacketType::FRAME_ADVANTAGE:
+    {
+        const auto* frameAdvantagePacket = static_cast<const FrameAdvantagePacket*>(packet);
+        const auto playerNumber = gameManager_.GetPlayerNumber();
+        if (playerNumber == INVALID_PLAYER)
+        {
+            break;
+        }
+        std::array<std::uint8_t, sizeof(float)> frameAdvantage{};
+        std::copy_n(frameAdvantagePacket->frameAdvantages.begin() + playerNumber * sizeof(float),
+            sizeof(float), frameAdvantage.begin());
+        gameManager_.SetFrameAdvantage(core::ConvertFromBinary<float>(frameAdvantage));
+        break;
+    }
     case PacketType::PING:
     {
         const auto* pingPacket = static_cast<const PingPacket*>(packet);
         const auto clientId = core::ConvertFromBinary<ClientId>(pingPacket->clientId);
         if (clientId == clientId_)
         {
-            const auto originTime = core::ConvertFromBinary<unsigned long long>(pingPacket->time);
-            using namespace std::chrono;
-            const auto currentTime = duration_cast<duration<unsigned long long, std::milli>>(
-                system_clock::now().time_since_epoch()
-                ).count();
+            const auto originTime = core::ConvertFromBinary<long long>(pingPacket->time);
+            const auto currentTime = GetClockTime();
             const auto delta = currentTime - originTime;
             const auto ping = static_cast<float>(delta);
+            clockSync_.AddSample(originTime, core::ConvertFromBinary<long long>(pingPacket->serverTime), currentTime);
 
             //calculate average and var ping
             if (srtt_ < 0.0f)
@@ -145,6 +163,10 @@ void Client::ReceivePacket(const Packet* packet)
 
             rto_ = srtt_ + std::max(g, k * rttvar_);
             currentPing_ = srtt_;
+            if (inputDelayMode_ == InputDelayMode::ADAPTIVE)
+            {
+                UpdateAdaptiveInputDelay();
+            }
         }
 
     }
@@ -154,6 +176,61 @@ void Client::ReceivePacket(const Packet* packet)
 
 }
 
+void Client::SetInputDelayMode(InputDelayMode inputDelayMode, Frame fixedInputDelay)
+{
+    std::scoped_lock lock(gameManager_.GetSimulationMutex());
+    inputDelayMode_ = inputDelayMode;
+    fixedInputDelay_ = fixedInputDelay;
+    gameManager_.SetInputDelay(fixedInputDelay);
+    if (inputDelayMode_ == InputDelayMode::ADAPTIVE && srtt_ > 0.0f)
+    {
+        UpdateAdaptiveInputDelay();
+    }
+}
+
+void Client::UpdateAdaptiveInputDelay()
+{
+    //A remote input goes through the server, so it arrives about one round trip after being sent
+    const float latency = srtt_ + inputDelayJitterFactor * rttvar_;
+    const auto targetDelay = static_cast<Frame>(std::ceil(latency / (fixedPeriod * 1000.0f)));
+    const auto inputDelay = gameManager_.GetInputDelay();
+    //One frame per ping, with one frame of hysteresis before shrinking
+    if (targetDelay > inputDelay)
+    {
+        gameManager_.SetInputDelay(inputDelay + 1);
+    }
+    else if (targetDelay + 1 < inputDelay)
+    {
+        gameManager_.SetInputDelay(inputDelay - 1);
+    }
+}
+
+void Client::DrawInputDelayImGui()
+{
+    bool isAdaptive = inputDelayMode_ == InputDelayMode::ADAPTIVE;
+    int fixedInputDelay = static_cast<int>(fixedInputDelay_);
+    bool hasChanged = ImGui::Checkbox("Adaptive Input Delay", &isAdaptive);
+    if (!isAdaptive)
+    {
+        hasChanged |= ImGui::SliderInt("Input Delay", &fixedInputDelay, 0, static_cast<int>(maxInputDelay));
+    }
+    if (hasChanged)
+    {
+        SetInputDelayMode(isAdaptive ? InputDelayMode::ADAPTIVE : InputDelayMode::FIXED, static_cast<Frame>(fixedInputDelay));
+    }
+}
+
+void Client::DrawClockSyncImGui()
+{
+    if (!clockSync_.HasEstimate())
+    {
+        ImGui::Text("Clock offset: no ping answered");
+        return;
+    }
+    ImGui::Text("Clock offset: %.1f ms (min RTT %lld ms)", clockSync_.GetOffset(GetClockTime()), clockSync_.GetMinRtt());
+    ImGui::Text("Clock skew: %.1f ppm", clockSync_.GetSkew() * 1.0e6);
+}
+
 void Client::Update(sf::Time dt)
 {
 
@@ -165,10 +242,8 @@ void Client::Update(sf::Time dt)
     {
         if (clientId_ != INVALID_CLIENT_ID)
         {
-            using namespace std::chrono;
             auto pingPacket = std::make_unique<PingPacket>();
-            pingPacket->time = core::ConvertToBinary(duration_cast<duration<unsigned long long, std::milli>>(
-                system_clock::now().time_since_epoch()).count());
+            pingPacket->time = core::ConvertToBinary(GetClockTime());
             pingPacket->clientId = core::ConvertToBinary(clientId_);
             SendUnreliablePacket(std::move(pingPacket));
         }
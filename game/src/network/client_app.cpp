@@ -17,6 +17,7 @@ void ClientApp::Begin()
 #endif
     windowSize_ = core::windowSize;
     client_.SetWindowSize(windowSize_);
+    client_.SetSimulationThreaded(true);
     client_.Begin();
 }
 
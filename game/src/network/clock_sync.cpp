@@ -0,0 +1,118 @@
+#include "network/clock_sync.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+std::atomic<ClockFunction> clockFunction = nullptr;
+}
+
+void SetClockFunction(ClockFunction newClockFunction)
+{
+    clockFunction.store(newClockFunction, std::memory_order_release);
+}
+
+long long GetClockTime()
+{
+    if (const auto customClockFunction = clockFunction.load(std::memory_order_acquire); customClockFunction != nullptr)
+    {
+        return customClockFunction();
+    }
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void ClockSync::AddSample(long long clientSendTime, long long serverTime, long long clientReceiveTime)
+{
+    if (clientReceiveTime < clientSendTime)
+    {
+        return;
+    }
+    auto& sample = samples_[nextSample_];
+    sample.rtt = clientReceiveTime - clientSendTime;
+    //The server time is taken at the middle of the round trip
+    sample.clientTime = clientSendTime + sample.rtt / 2;
+    sample.offset = static_cast<double>(serverTime) - static_cast<double>(clientSendTime + clientReceiveTime) / 2.0;
+    nextSample_ = (nextSample_ + 1) % samples_.size();
+    sampleCount_ = std::min(sampleCount_ + 1, samples_.size());
+    UpdateEstimate();
+}
+
+void ClockSync::Reset()
+{
+    sampleCount_ = 0;
+    nextSample_ = 0;
+    referenceTime_ = 0;
+    minRtt_ = 0;
+    offset_ = 0.0;
+    skew_ = 0.0;
+}
+
+double ClockSync::GetOffset(long long clientTime) const
+{
+    return offset_ + skew_ * static_cast<double>(clientTime - referenceTime_);
+}
+
+long long ClockSync::ToLocalTime(long long serverTime) const
+{
+    //The offset barely changes over the conversion, so it is evaluated at the approximated local time
+    const auto approximatedTime = serverTime - std::llround(offset_);
+    return serverTime - std::llround(GetOffset(approximatedTime));
+}
+
+long long ClockSync::ToServerTime(long long clientTime) const
+{
+    return clientTime + std::llround(GetOffset(clientTime));
+}
+
+void ClockSync::UpdateEstimate()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::array<Sample, clockSyncSampleNmb> sortedSamples{};
+    std::copy_n(samples_.begin(), sampleCount_, sortedSamples.begin());
+    const auto samplesBegin = sortedSamples.begin();
+    const auto samplesMiddle = samplesBegin + static_cast<std::ptrdiff_t>(sampleCount_ / 2);
+    const auto samplesEnd = samplesBegin + static_cast<std::ptrdiff_t>(sampleCount_);
+    std::sort(samplesBegin, samplesEnd, [](const Sample& sample1, const Sample& sample2)
+    {
+        return sample1.clientTime < sample2.clientTime;
+    });
+    const auto compareRtt = [](const Sample& sample1, const Sample& sample2)
+    {
+        return sample1.rtt < sample2.rtt;
+    };
+    const auto& bestSample = *std::min_element(samplesBegin, samplesEnd, compareRtt);
+    minRtt_ = bestSample.rtt;
+    offset_ = bestSample.offset;
+    referenceTime_ = bestSample.clientTime;
+
+    //The skew is the slope between the best samples of the older and the newer halves of the window
+    skew_ = 0.0;
+    if (samplesMiddle == samplesBegin)
+    {
+        return;
+    }
+    const auto& olderSample = *std::min_element(samplesBegin, samplesMiddle, compareRtt);
+    const auto& newerSample = *std::min_element(samplesMiddle, samplesEnd, compareRtt);
+    const auto timeDelta = newerSample.clientTime - olderSample.clientTime;
+    if (timeDelta < minClockSkewTime)
+    {
+        return;
+    }
+    skew_ = std::clamp((newerSample.offset - olderSample.offset) / static_cast<double>(timeDelta),
+        -maxClockSkew, maxClockSkew);
+}
+}
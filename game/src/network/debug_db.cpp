@@ -21,12 +21,9 @@ namespace fs = std::filesystem;
 namespace game
 {
 
-static int callback([[maybe_unused]] void* NotUsed, int argc, char** argv, char** azColName)
+DebugDatabase::~DebugDatabase()
 {
-    for (int i = 0; i < argc; i++) {
-        core::LogDebug(fmt::format("{} = {}", azColName[i], argv[i] ? argv[i] : "NULL"));
-    }
-    return 0;
+    Close();
 }
 
 void DebugDatabase::Open(std::string_view path)
@@ -35,16 +32,21 @@ void DebugDatabase::Open(std::string_view path)
     {
         fs::remove(path);
     }
-    const auto rc = sqlite3_open(path.data(), &db);
+    const auto rc = sqlite3_open(path.data(), &db_);
     if (rc != SQLITE_OK)
     {
-        core::LogError(fmt::format("Can't open database: {}\n", sqlite3_errmsg(db)));
-        sqlite3_close(db);
-        db = nullptr;
+        core::LogError(fmt::format("Can't open database: {}\n", sqlite3_errmsg(db_)));
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return;
     }
+    //The database is only a debug log, losing the last transactions on a crash of the OS is acceptable
+    Execute("PRAGMA journal_mode=WAL;");
+    Execute("PRAGMA synchronous=NORMAL;");
     CreateTables();
+    PrepareStatements();
+    isOver_ = false;
     t_ = std::thread{ &DebugDatabase::Loop, this };
-    t_.detach();
 }
 
 void DebugDatabase::StorePacket(const PlayerInputPacket* inputPacket)
@@ -52,22 +54,17 @@ void DebugDatabase::StorePacket(const PlayerInputPacket* inputPacket)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    const PlayerNumber playerNumber = inputPacket->playerNumber;
-    const auto frame = core::ConvertFromBinary<Frame>(inputPacket->currentFrame);
-    const PlayerInput input = inputPacket->inputs[0];
-
-    auto query = fmt::format("INSERT INTO inputs (player_number, frame, up, down, left, right, shoot) VALUES({}, {}, {}, {}, {}, {},  {});",
-        playerNumber,
-        frame,
-        (input & PlayerInputEnum::UP) == PlayerInputEnum::UP,
-        (input & PlayerInputEnum::DOWN) == PlayerInputEnum::DOWN,
-        (input & PlayerInputEnum::LEFT) == PlayerInputEnum::LEFT,
-        (input & PlayerInputEnum::RIGHT) == PlayerInputEnum::RIGHT,
-        (input & PlayerInputEnum::SHOOT) == PlayerInputEnum::SHOOT);
-
+    if (db_ == nullptr)
+    {
+        return;
+    }
+    DbInput input;
+    input.playerNumber = inputPacket->playerNumber;
+    input.frame = core::ConvertFromBinary<Frame>(inputPacket->currentFrame);
+    input.input = inputPacket->inputs[0];
     {
         std::lock_guard lock(m_);
-        commands_.push_back(query);
+        inputs_.push_back(input);
     }
 
     cv_.notify_one();
@@ -78,19 +75,13 @@ void DebugDatabase::StorePhysicsState(const DbPhysicsState& physicsState)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-
-    std::string query = "INSERT INTO physics_state (local_frame, validate_frame ";
-    std::string arguments;
-    std::string values = fmt::format(" VALUES ({}, {}", physicsState.lastLocalValidateFrame, physicsState.validateFrame);
-    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    if (db_ == nullptr)
     {
-        arguments += fmt::format(",state_p{}_local, state_p{}_server ", playerNumber + 1, playerNumber + 1);
-        values += fmt::format(",{},{}", physicsState.localStates[playerNumber], physicsState.serverStates[playerNumber]);
+        return;
     }
-    query += arguments + ") " + values + " );";
     {
         std::lock_guard lock(m_);
-        commands_.push_back(query);
+        physicsStates_.push_back(physicsState);
     }
 
     cv_.notify_one();
@@ -98,50 +89,123 @@ void DebugDatabase::StorePhysicsState(const DbPhysicsState& physicsState)
 
 void DebugDatabase::Close()
 {
-    isOver_.store(true, std::memory_order_release);
+    {
+        std::lock_guard lock(m_);
+        isOver_ = true;
+    }
     cv_.notify_one();
-
-    //t_.join();
-    if (db != nullptr)
+    if (t_.joinable())
     {
-        sqlite3_close(db);
-        db = nullptr;
+        t_.join();
+    }
+    sqlite3_finalize(insertInput_);
+    insertInput_ = nullptr;
+    sqlite3_finalize(insertPhysicsState_);
+    insertPhysicsState_ = nullptr;
+    if (db_ != nullptr)
+    {
+        sqlite3_close(db_);
+        db_ = nullptr;
     }
 }
 
 void DebugDatabase::Loop()
 {
+    std::vector<DbInput> inputs;
+    std::vector<DbPhysicsState> physicsStates;
     std::unique_lock lock(m_);
-    while (!isOver_.load(std::memory_order_acquire))
+    while (true)
     {
-        while (!commands_.empty())
+        cv_.wait(lock, [this] { return isOver_ || !inputs_.empty() || !physicsStates_.empty(); });
+        if (inputs_.empty() && physicsStates_.empty())
         {
-            if (isOver_.load(std::memory_order_acquire))
-            {
-                break;
-            }
+            //Closing and everything was written
+            break;
+        }
+        //Swap the queues so that the game thread keeps storing records while they are written
+        std::swap(inputs, inputs_);
+        std::swap(physicsStates, physicsStates_);
+        lock.unlock();
+
+        WriteRecords(inputs, physicsStates);
+        inputs.clear();
+        physicsStates.clear();
+
+        lock.lock();
+    }
+}
+
+void DebugDatabase::WriteRecords(const std::vector<DbInput>& inputs, const std::vector<DbPhysicsState>& physicsStates) const
+{
 #ifdef TRACY_ENABLE
-            ZoneNamedN(sqlExecuteCommand, "SQL Execute Command", true);
+    ZoneScoped;
 #endif
-            std::string command = std::move(commands_[0]);
-            commands_.erase(commands_.begin());
-            lock.unlock();
-            /* Execute SQL statement */
-
-            char* zErrMsg = nullptr;
-            const auto rc = sqlite3_exec(db, command.c_str(), callback, nullptr, &zErrMsg);
-
-            if (rc != SQLITE_OK) {
-                core::LogError(fmt::format("SQL error with storing input: {}", zErrMsg));
-                sqlite3_free(zErrMsg);
-            }
-            lock.lock();
+    Execute("BEGIN TRANSACTION;");
+    for (const auto& input : inputs)
+    {
+        sqlite3_bind_int(insertInput_, 1, input.playerNumber);
+        sqlite3_bind_int64(insertInput_, 2, input.frame);
+        sqlite3_bind_int(insertInput_, 3, (input.input & PlayerInputEnum::UP) == PlayerInputEnum::UP);
+        sqlite3_bind_int(insertInput_, 4, (input.input & PlayerInputEnum::DOWN) == PlayerInputEnum::DOWN);
+        sqlite3_bind_int(insertInput_, 5, (input.input & PlayerInputEnum::LEFT) == PlayerInputEnum::LEFT);
+        sqlite3_bind_int(insertInput_, 6, (input.input & PlayerInputEnum::RIGHT) == PlayerInputEnum::RIGHT);
+        sqlite3_bind_int(insertInput_, 7, (input.input & PlayerInputEnum::SHOOT) == PlayerInputEnum::SHOOT);
+        if (sqlite3_step(insertInput_) != SQLITE_DONE)
+        {
+            core::LogError(fmt::format("SQL error with storing input: {}", sqlite3_errmsg(db_)));
         }
-        if (isOver_.load(std::memory_order_acquire))
-            break;
-        cv_.wait(lock);
+        sqlite3_reset(insertInput_);
+    }
+    for (const auto& physicsState : physicsStates)
+    {
+        sqlite3_bind_int64(insertPhysicsState_, 1, physicsState.lastLocalValidateFrame);
+        sqlite3_bind_int64(insertPhysicsState_, 2, physicsState.validateFrame);
+        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            sqlite3_bind_int(insertPhysicsState_, 3 + 2 * playerNumber, physicsState.localStates[playerNumber]);
+            sqlite3_bind_int(insertPhysicsState_, 4 + 2 * playerNumber, physicsState.serverStates[playerNumber]);
+        }
+        if (sqlite3_step(insertPhysicsState_) != SQLITE_DONE)
+        {
+            core::LogError(fmt::format("SQL error with storing physics state: {}", sqlite3_errmsg(db_)));
+        }
+        sqlite3_reset(insertPhysicsState_);
+    }
+    Execute("COMMIT;");
+}
+
+bool DebugDatabase::Execute(const char* command) const
+{
+    char* zErrMsg = nullptr;
+    const auto rc = sqlite3_exec(db_, command, nullptr, nullptr, &zErrMsg);
+    if (rc != SQLITE_OK) {
+        core::LogError(fmt::format("SQL error with {}: {}", command, zErrMsg));
+        sqlite3_free(zErrMsg);
+        return false;
+    }
+    return true;
+}
+
+void DebugDatabase::PrepareStatements()
+{
+    const auto insertInput = "INSERT INTO inputs (player_number, frame, up, down, left, right, shoot) VALUES(?, ?, ?, ?, ?, ?, ?);";
+    if (sqlite3_prepare_v2(db_, insertInput, -1, &insertInput_, nullptr) != SQLITE_OK)
+    {
+        core::LogError(fmt::format("SQL error while preparing input statement: {}", sqlite3_errmsg(db_)));
+    }
+
+    std::string insertPhysicsState = "INSERT INTO physics_state (local_frame, validate_frame";
+    std::string values = " VALUES (?, ?";
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        insertPhysicsState += fmt::format(", state_p{}_local, state_p{}_server", playerNumber + 1, playerNumber + 1);
+        values += ", ?, ?";
+    }
+    insertPhysicsState += ")" + values + ");";
+    if (sqlite3_prepare_v2(db_, insertPhysicsState.c_str(), -1, &insertPhysicsState_, nullptr) != SQLITE_OK)
+    {
+        core::LogError(fmt::format("SQL error while preparing physics state statement: {}", sqlite3_errmsg(db_)));
     }
-    isOver_ = false;
 }
 
 void DebugDatabase::CreateTables() const
@@ -157,16 +221,7 @@ void DebugDatabase::CreateTables() const
         "left INTEGER NOT NULL,"\
         "right INTEGER NOT NULL,"\
         "shoot INTEGER NOT NULL);";
-
-    /* Execute SQL statement */
-
-    char* zErrMsg = nullptr;
-    const auto rc = sqlite3_exec(db, createInputTable, callback, nullptr, &zErrMsg);
-
-    if (rc != SQLITE_OK) {
-        core::LogError(fmt::format("SQL error while creating table: {}", zErrMsg));
-        sqlite3_free(zErrMsg);
-    }
+    Execute(createInputTable);
 
     std::string createPhysicsStateTable = "CREATE TABLE physics_state ("\
         "phys_id INTEGER PRIMARY KEY,"\
@@ -178,13 +233,8 @@ void DebugDatabase::CreateTables() const
         createPhysicsStateTable += fmt::format(",state_p{}_local INTEGER NOT NULL, state_p{}_server INTEGER NOT NULL", playerNumber + 1, playerNumber + 1);
     }
     createPhysicsStateTable += ");";
-    zErrMsg = nullptr;
-    const auto rc2 = sqlite3_exec(db, createPhysicsStateTable.data(), callback, nullptr, &zErrMsg);
-    if (rc2 != SQLITE_OK) {
-        core::LogError(fmt::format("SQL error while creating table: {}", zErrMsg));
-        sqlite3_free(zErrMsg);
-    }
+    Execute(createPhysicsStateTable.c_str());
 }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,106 @@
+#include "network/link_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+void LinkModel::SetSeed(std::uint32_t seed, std::uint32_t stream)
+{
+    std::seed_seq seedSequence{ seed, stream };
+    randomEngine_.seed(seedSequence);
+    isBadState_ = false;
+    linkFreeTime_ = 0.0;
+    lastReliableDeliveryTime_ = 0.0;
+}
+
+Transmission LinkModel::Transmit(double sendTime, std::size_t packetSize, bool isReliable)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    Transmission transmission;
+    //The packet uses the link even if it is lost afterwards
+    double departureTime = sendTime;
+    if (config_.bandwidth > 0.0f)
+    {
+        linkFreeTime_ = std::max(linkFreeTime_, sendTime) + static_cast<double>(packetSize) / config_.bandwidth;
+        departureTime = linkFreeTime_;
+    }
+    if (isReliable)
+    {
+        lastReliableDeliveryTime_ = std::max(lastReliableDeliveryTime_, departureTime + GetRandomDelay());
+        transmission.copyNmb = 1;
+        transmission.deliveryTimes[0] = lastReliableDeliveryTime_;
+        return transmission;
+    }
+
+    //The state changes once per packet, the bad state lasts on average 1/badToGood packets
+    isBadState_ = isBadState_ ? !IsTrue(config_.badToGood) : IsTrue(config_.goodToBad);
+    if (IsTrue(isBadState_ ? config_.lossBad : config_.lossGood))
+    {
+        return transmission;
+    }
+    const auto copyNmb = IsTrue(config_.duplicateRate) ? 2u : 1u;
+    for (std::size_t i = 0; i < copyNmb; i++)
+    {
+        double deliveryTime = departureTime + GetRandomDelay();
+        if (IsTrue(config_.reorderRate))
+        {
+            deliveryTime += config_.reorderDelay;
+        }
+        transmission.deliveryTimes[i] = deliveryTime;
+    }
+    transmission.copyNmb = copyNmb;
+    return transmission;
+}
+
+float LinkModel::GetRandomDelay()
+{
+    float delay = config_.delay;
+    if (config_.jitter > 0.0f)
+    {
+        switch (config_.jitterDistribution)
+        {
+        case JitterDistribution::UNIFORM:
+            delay += static_cast<float>((2.0 * DrawUniform() - 1.0) * config_.jitter);
+            break;
+        case JitterDistribution::NORMAL:
+        {
+            //Box-Muller transform, 1 - U is in (0, 1] so its logarithm is finite
+            const auto radius = std::sqrt(-2.0 * std::log(1.0 - DrawUniform()));
+            const auto angle = 2.0 * std::numbers::pi * DrawUniform();
+            delay += static_cast<float>(radius * std::cos(angle) * config_.jitter);
+            break;
+        }
+        case JitterDistribution::EXPONENTIAL:
+            //Inverse transform sampling, the mean is the jitter
+            delay += static_cast<float>(-std::log(1.0 - DrawUniform()) * config_.jitter);
+            break;
+        }
+    }
+    return std::max(delay, 0.0f);
+}
+
+bool LinkModel::IsTrue(float probability)
+{
+    //A disabled feature does not draw from the random engine, the default link only draws the delays
+    if (probability <= 0.0f)
+    {
+        return false;
+    }
+    return DrawUniform() < probability;
+}
+
+double LinkModel::DrawUniform()
+{
+    static_assert(std::mt19937::min() == 0u && std::mt19937::max() == 0xFFFFFFFFu, "One draw is 32 random bits");
+    return static_cast<double>(randomEngine_()) / 4294967296.0;
+}
+}
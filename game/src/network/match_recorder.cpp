@@ -0,0 +1,206 @@
+#include "network/match_recorder.h"
+
+#include <cstring>
+#include <string>
+
+#include "game/game_manager.h"
+#include "game/state_history.h"
+#include "utils/assert.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+MatchRecorder::~MatchRecorder()
+{
+    Close();
+}
+
+bool MatchRecorder::Open(std::string_view path)
+{
+    Close();
+    file_.open(std::string(path), std::ios::binary | std::ios::trunc);
+    if (!file_)
+    {
+        core::LogError(fmt::format("Could not create the match recording {}", path));
+        return false;
+    }
+    isOpen_ = true;
+    isOver_ = false;
+    buffer_.reserve(recordingFlushSize);
+    WriteHeader();
+    t_ = std::thread{ &MatchRecorder::Loop, this };
+    return true;
+}
+
+void MatchRecorder::OpenStream()
+{
+    Close();
+    isOpen_ = true;
+    isStream_ = true;
+    buffer_.clear();
+    WriteHeader();
+}
+
+void MatchRecorder::Close()
+{
+    if (!isOpen_)
+    {
+        return;
+    }
+    isOpen_ = false;
+    if (isStream_)
+    {
+        isStream_ = false;
+        return;
+    }
+    EndRecord(true);
+    {
+        std::scoped_lock lock(m_);
+        isOver_ = true;
+    }
+    cv_.notify_one();
+    t_.join();
+    file_.close();
+}
+
+void MatchRecorder::RecordKeyframe(const GameManager& gameManager)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!isOpen_)
+    {
+        return;
+    }
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    const auto& world = rollbackManager.GetValidateWorld();
+    Write(MatchRecordType::KEYFRAME);
+    Write(rollbackManager.GetLastValidateFrame());
+    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        Write(gameManager.GetEntityFromPlayerNumber(playerNumber));
+    }
+    Write(static_cast<std::uint64_t>(world.GetSize()));
+    WriteBytes(world.GetData(), world.GetSize());
+    //A keyframe is a point where a replay can start, it is written to the file right away
+    EndRecord(true);
+}
+
+void MatchRecorder::RecordFrames(const RollbackManager& rollbackManager, Frame firstFrame, Frame lastFrame)
+{
+    if (!isOpen_ || lastFrame < firstFrame)
+    {
+        return;
+    }
+    const auto currentFrame = rollbackManager.GetCurrentFrame();
+    const auto& stateHistory = rollbackManager.GetStateHistory();
+    Write(MatchRecordType::FRAMES);
+    Write(firstFrame);
+    Write(static_cast<std::uint32_t>(lastFrame - firstFrame + 1));
+    for (Frame frame = firstFrame; frame <= lastFrame; frame++)
+    {
+        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            Write(rollbackManager.GetInputs(playerNumber)[currentFrame - frame]);
+        }
+        const auto* frameState = stateHistory.FindFrameState(frame);
+        gpr_assert(frameState != nullptr, "The recorded frames need to be in the state history");
+        Write(ComputeStateHash(*frameState));
+    }
+    EndRecord(false);
+}
+
+void MatchRecorder::RecordEnd(Frame frame, PlayerNumber winner)
+{
+    if (!isOpen_)
+    {
+        return;
+    }
+    Write(MatchRecordType::END);
+    Write(frame);
+    Write(winner);
+    EndRecord(true);
+}
+
+void MatchRecorder::WriteHeader()
+{
+    Write(matchRecordingMagic);
+    Write(matchRecordingVersion);
+    Write(static_cast<std::uint8_t>(maxPlayerNmb));
+    Write(recordingKeyframePeriod);
+    Write(fixedPeriod);
+}
+
+void MatchRecorder::WriteBytes(const void* data, std::size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    const auto offset = buffer_.size();
+    buffer_.resize(offset + size);
+    std::memcpy(buffer_.data() + offset, data, size);
+}
+
+void MatchRecorder::EndRecord(bool isFlushed)
+{
+    if (isStream_ || buffer_.empty() || (!isFlushed && buffer_.size() < recordingFlushSize))
+    {
+        return;
+    }
+    {
+        std::scoped_lock lock(m_);
+        if (pendingBuffer_.empty())
+        {
+            std::swap(pendingBuffer_, buffer_);
+        }
+        else
+        {
+            //The worker thread is late, the records are appended to the ones it has not taken yet
+            pendingBuffer_.insert(pendingBuffer_.end(), buffer_.begin(), buffer_.end());
+            buffer_.clear();
+        }
+    }
+    cv_.notify_one();
+}
+
+void MatchRecorder::Loop()
+{
+    std::vector<std::byte> writtenBuffer;
+    bool isWriteFailed = false;
+    std::unique_lock lock(m_);
+    while (true)
+    {
+        cv_.wait(lock, [this] { return isOver_ || !pendingBuffer_.empty(); });
+        if (pendingBuffer_.empty())
+        {
+            //Closing and everything was written
+            break;
+        }
+        std::swap(writtenBuffer, pendingBuffer_);
+        lock.unlock();
+
+#ifdef TRACY_ENABLE
+        ZoneNamedN(writeRecording, "Write Match Recording", true);
+#endif
+        file_.write(reinterpret_cast<const char*>(writtenBuffer.data()), static_cast<std::streamsize>(writtenBuffer.size()));
+        file_.flush();
+        if (!file_ && !isWriteFailed)
+        {
+            //The disk is full or the file is gone, the stream stays failed and the next records are lost
+            isWriteFailed = true;
+            core::LogError("Could not write the match recording, the next records are lost");
+        }
+        writtenBuffer.clear();
+
+        lock.lock();
+    }
+}
+}
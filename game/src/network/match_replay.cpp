@@ -0,0 +1,396 @@
+#include "network/match_replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "game/game_manager.h"
+#include "game/state_history.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+/**
+ * \brief RecordCursor reads the values of a recording one after the other, without reading past its end.
+ */
+class RecordCursor
+{
+public:
+    RecordCursor(const std::vector<std::byte>& data, std::size_t offset) : data_(data), offset_(offset) {}
+    template<typename T>
+    bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Records are copied as raw memory");
+        if (!CanRead(sizeof(T)))
+        {
+            return false;
+        }
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+    bool Skip(std::size_t size)
+    {
+        if (!CanRead(size))
+        {
+            return false;
+        }
+        offset_ += size;
+        return true;
+    }
+    [[nodiscard]] bool CanRead(std::size_t size) const { return size <= data_.size() - offset_; }
+    [[nodiscard]] std::size_t GetOffset() const { return offset_; }
+    [[nodiscard]] bool IsAtEnd() const { return offset_ == data_.size(); }
+private:
+    const std::vector<std::byte>& data_;
+    std::size_t offset_ = 0;
+};
+}
+
+/**
+ * \brief ReplayGameManager is the world of a ReplayPlayer, it is restored from the keyframes and validated with the recorded inputs.
+ */
+class ReplayGameManager final : public GameManager
+{
+public:
+    /**
+     * \brief LoadKeyframe is a method that replaces the world by the one of the keyframe.
+     * \return false if the keyframe world is truncated or corrupted, the world is then left unchanged
+     */
+    bool LoadKeyframe(const RecordedKeyframe& keyframe, const std::byte* data)
+    {
+
+#ifdef TRACY_ENABLE
+        ZoneScoped;
+#endif
+        rollbackState_.lastValidateWorld.CopyBytes(data, keyframe.size);
+        rollbackState_.playerEntities = keyframe.playerEntities;
+        rollbackState_.lastReceivedFrame.fill(keyframe.frame);
+        rollbackState_.lastValidateFrame = keyframe.frame;
+        rollbackState_.currentFrame = keyframe.frame;
+        //The keyframe comes from a file or from the network, it is checked before replacing the world
+        if (!rollbackManager_.CheckRollbackState(rollbackState_))
+        {
+            core::LogError(fmt::format("Keyframe of frame {} is truncated or corrupted", keyframe.frame));
+            return false;
+        }
+        playerEntityMap_ = keyframe.playerEntities;
+        currentFrame_ = keyframe.frame;
+        rollbackManager_.LoadRollbackState(rollbackState_);
+        return true;
+    }
+    void SetInputs(Frame frame, const std::array<PlayerInput, maxPlayerNmb>& inputs)
+    {
+        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            SetPlayerInput(playerNumber, inputs[playerNumber], frame);
+        }
+    }
+    /**
+     * \brief SimulateTo is a method that simulates the current world from the last validated frame up to frame.
+     */
+    void SimulateTo(Frame frame)
+    {
+        currentFrame_ = frame;
+        rollbackManager_.SimulateToCurrentFrame();
+    }
+private:
+    RollbackState rollbackState_;
+};
+
+bool MatchRecording::Load(std::string_view path)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    Clear();
+    std::ifstream file(std::string(path), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        core::LogError(fmt::format("Could not open the match recording {}", path));
+        return false;
+    }
+    std::vector<std::byte> data(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!Append(data.data(), data.size()))
+    {
+        core::LogError(fmt::format("Could not load the match recording {}", path));
+        return false;
+    }
+    if (!HasHeader())
+    {
+        core::LogError(fmt::format("Match recording {} has no header", path));
+        return false;
+    }
+    if (parsedSize_ != data_.size())
+    {
+        core::LogWarning(fmt::format("Match recording {} ends with a truncated record, it is ignored", path));
+    }
+    if (keyframes_.empty())
+    {
+        core::LogError(fmt::format("Match recording {} has no keyframe", path));
+        return false;
+    }
+    return true;
+}
+
+bool MatchRecording::Append(const std::byte* data, std::size_t size)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    data_.insert(data_.end(), data, data + size);
+    RecordCursor cursor(data_, parsedSize_);
+    if (!HasHeader())
+    {
+        std::array<char, 4> magic{};
+        std::uint16_t version = 0;
+        std::uint8_t playerNmb = 0;
+        Frame keyframePeriod = 0;
+        float recordedFixedPeriod = 0.0f;
+        if (!cursor.Read(magic) || !cursor.Read(version) || !cursor.Read(playerNmb) ||
+            !cursor.Read(keyframePeriod) || !cursor.Read(recordedFixedPeriod))
+        {
+            //The header is not complete yet
+            return true;
+        }
+        if (magic != matchRecordingMagic || version != matchRecordingVersion ||
+            playerNmb != maxPlayerNmb || recordedFixedPeriod != fixedPeriod)
+        {
+            core::LogError("The match recording was not recorded by this version of the game");
+            return false;
+        }
+        parsedSize_ = cursor.GetOffset();
+    }
+
+    bool isComplete = true;
+    while (!cursor.IsAtEnd() && isComplete)
+    {
+        RecordInfo record;
+        record.offset = cursor.GetOffset();
+        isComplete = cursor.Read(record.type);
+        switch (record.type)
+        {
+        case MatchRecordType::KEYFRAME:
+        {
+            RecordedKeyframe keyframe;
+            std::uint64_t keyframeSize = 0;
+            isComplete = isComplete && cursor.Read(keyframe.frame) && cursor.Read(keyframe.playerEntities) && cursor.Read(keyframeSize);
+            keyframe.offset = cursor.GetOffset();
+            keyframe.size = static_cast<std::size_t>(keyframeSize);
+            isComplete = isComplete && cursor.Skip(keyframe.size);
+            if (!isComplete)
+            {
+                break;
+            }
+            if (keyframes_.empty())
+            {
+                //A stream joined during the match starts at its first keyframe
+                firstFrame_ = keyframe.frame;
+            }
+            else if (keyframe.frame != GetLastFrame())
+            {
+                core::LogError(fmt::format("The match recording has a keyframe at frame {} after the frame {}", keyframe.frame, GetLastFrame()));
+                return false;
+            }
+            keyframes_.push_back(keyframe);
+            record.frame = keyframe.frame;
+            break;
+        }
+        case MatchRecordType::FRAMES:
+        {
+            Frame firstFrame = 0;
+            std::uint32_t frameCount = 0;
+            isComplete = isComplete && cursor.Read(firstFrame) && cursor.Read(frameCount) &&
+                cursor.CanRead(frameCount * (maxPlayerNmb * sizeof(PlayerInput) + sizeof(std::uint64_t)));
+            if (!isComplete)
+            {
+                break;
+            }
+            if (keyframes_.empty() || firstFrame != GetLastFrame() + 1)
+            {
+                core::LogError(fmt::format("The match recording is missing the frames {} to {}", GetLastFrame() + 1, firstFrame - 1));
+                return false;
+            }
+            for (std::uint32_t i = 0; i < frameCount; i++)
+            {
+                cursor.Read(inputs_.emplace_back());
+                cursor.Read(stateHashes_.emplace_back());
+            }
+            auto& validation = validations_.emplace_back();
+            validation.frame = GetLastFrame();
+            record.frame = validation.frame;
+            break;
+        }
+        case MatchRecordType::END:
+        {
+            Frame frame = 0;
+            PlayerNumber winner = INVALID_PLAYER;
+            isComplete = isComplete && cursor.Read(frame) && cursor.Read(winner);
+            if (isComplete)
+            {
+                winner_ = winner;
+                record.frame = frame;
+            }
+            break;
+        }
+        default:
+            core::LogError(fmt::format("The match recording has an unknown record at {}", record.offset));
+            return false;
+        }
+        if (isComplete)
+        {
+            record.size = cursor.GetOffset() - record.offset;
+            records_.push_back(record);
+            parsedSize_ = cursor.GetOffset();
+        }
+    }
+    return true;
+}
+
+void MatchRecording::Clear()
+{
+    data_.clear();
+    parsedSize_ = 0;
+    firstFrame_ = 0;
+    inputs_.clear();
+    stateHashes_.clear();
+    keyframes_.clear();
+    validations_.clear();
+    records_.clear();
+    winner_ = INVALID_PLAYER;
+}
+
+const RecordedKeyframe& MatchRecording::FindKeyframe(Frame frame) const
+{
+    const auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame,
+        [](Frame value, const RecordedKeyframe& keyframe)
+        {
+            return value < keyframe.frame;
+        });
+    return it == keyframes_.begin() ? keyframes_.front() : *(it - 1);
+}
+
+ReplayPlayer::ReplayPlayer(const MatchRecording& recording) :
+    recording_(recording), gameManager_(std::make_unique<ReplayGameManager>())
+{
+    isValid_ = LoadKeyframe(recording_.GetKeyframes().front());
+    if (isValid_)
+    {
+        gameManager_->SimulateTo(frame_);
+    }
+}
+
+ReplayPlayer::~ReplayPlayer() = default;
+
+void ReplayPlayer::Seek(Frame frame)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!isValid_)
+    {
+        return;
+    }
+    const auto targetFrame = std::clamp(frame, recording_.GetFirstFrame(), recording_.GetLastFrame());
+    const auto& keyframe = recording_.FindKeyframe(targetFrame);
+    const auto lastValidateFrame = gameManager_->GetLastValidateFrame();
+    if (targetFrame < lastValidateFrame || keyframe.frame > lastValidateFrame)
+    {
+        if (!LoadKeyframe(keyframe))
+        {
+            isValid_ = false;
+            return;
+        }
+    }
+    SimulateTo(targetFrame);
+}
+
+void ReplayPlayer::Advance(Frame frameCount)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (!isValid_)
+    {
+        return;
+    }
+    SimulateTo(std::min(frame_ + frameCount, recording_.GetLastFrame()));
+}
+
+void ReplayPlayer::SimulateTo(Frame targetFrame)
+{
+    const auto& validations = recording_.GetValidations();
+    while (nextValidation_ < validations.size() && validations[nextValidation_].frame <= targetFrame)
+    {
+        Validate(validations[nextValidation_]);
+        nextValidation_++;
+    }
+    //The frames after the last validation are simulated without being validated,
+    //the next validation is still done at the same frame as the server
+    for (Frame inputFrame = gameManager_->GetLastValidateFrame() + 1; inputFrame <= targetFrame; inputFrame++)
+    {
+        gameManager_->SetInputs(inputFrame, recording_.GetInputs(inputFrame));
+    }
+    gameManager_->SimulateTo(targetFrame);
+    frame_ = targetFrame;
+}
+
+const GameManager& ReplayPlayer::GetGameManager() const
+{
+    return *gameManager_;
+}
+
+bool ReplayPlayer::LoadKeyframe(const RecordedKeyframe& keyframe)
+{
+    if (!gameManager_->LoadKeyframe(keyframe, recording_.GetKeyframeData(keyframe)))
+    {
+        return false;
+    }
+    const auto& validations = recording_.GetValidations();
+    nextValidation_ = static_cast<std::size_t>(std::upper_bound(validations.begin(), validations.end(), keyframe.frame,
+        [](Frame value, const RecordedValidation& validation)
+        {
+            return value < validation.frame;
+        }) - validations.begin());
+    frame_ = keyframe.frame;
+    return true;
+}
+
+void ReplayPlayer::Validate(const RecordedValidation& validation)
+{
+    const auto firstFrame = gameManager_->GetLastValidateFrame() + 1;
+    for (Frame inputFrame = firstFrame; inputFrame <= validation.frame; inputFrame++)
+    {
+        gameManager_->SetInputs(inputFrame, recording_.GetInputs(inputFrame));
+    }
+    gameManager_->Validate(validation.frame);
+    const auto& stateHistory = gameManager_->GetRollbackManager().GetStateHistory();
+    for (Frame frame = firstFrame; frame <= validation.frame; frame++)
+    {
+        const auto* frameState = stateHistory.FindFrameState(frame);
+        if (frameState == nullptr || ComputeStateHash(*frameState) != recording_.GetStateHash(frame))
+        {
+            if (desyncNmb_ == 0)
+            {
+                firstDesyncFrame_ = frame;
+            }
+            desyncNmb_++;
+        }
+    }
+}
+}
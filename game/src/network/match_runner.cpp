@@ -0,0 +1,380 @@
+#include "network/match_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "game/game_manager.h"
+#include "network/clock_sync.h"
+#include "network/match_replay.h"
+#include "network/simulation_client.h"
+#include "network/simulation_server.h"
+#include "network/spectator_relay.h"
+#include "utils/assert.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+std::atomic<long long> simulatedClockTime = 0;
+
+long long GetSimulatedClockTime()
+{
+    return simulatedClockTime.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief ValidatedState is the physics state of the server for a validated frame, compared with the clients ones.
+ */
+struct ValidatedState
+{
+    Frame frame = 0;
+    std::array<PhysicsState, maxPlayerNmb> physicsStates{};
+};
+}
+
+std::vector<ScriptedInput> LoadInputScript(std::string_view path)
+{
+    std::vector<ScriptedInput> inputScript;
+    std::ifstream file{ std::string(path) };
+    if (!file)
+    {
+        core::LogError(fmt::format("Could not open input script {}", path));
+        return inputScript;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+        std::istringstream lineStream(line);
+        unsigned frame = 0;
+        unsigned playerNumber = 0;
+        unsigned input = 0;
+        if (!(lineStream >> frame >> playerNumber >> input) || playerNumber >= maxPlayerNmb)
+        {
+            core::LogWarning(fmt::format("Invalid input script line: {}", line));
+            continue;
+        }
+        inputScript.push_back({ frame, static_cast<PlayerNumber>(playerNumber), static_cast<PlayerInput>(input) });
+    }
+    std::stable_sort(inputScript.begin(), inputScript.end(), [](const auto& input1, const auto& input2)
+    {
+        return input1.frame < input2.frame;
+    });
+    return inputScript;
+}
+
+MatchRunner::MatchRunner(MatchConfig config) : config_(std::move(config))
+{
+}
+
+MatchReport MatchRunner::Run()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    MatchReport report;
+    report.seed = config_.seed;
+
+    simulatedClockTime.store(0, std::memory_order_relaxed);
+    SetClockFunction(&GetSimulatedClockTime);
+    const auto fixedPeriodMs = std::llround(fixedPeriod * 1000.0f);
+    const auto dt = sf::seconds(fixedPeriod);
+
+    std::array<std::unique_ptr<SimulationClient>, maxPlayerNmb> clients;
+    SimulationServer server(clients);
+    server.SetSeed(config_.seed);
+    for (std::size_t clientIndex = 0; clientIndex < clients.size(); clientIndex++)
+    {
+        server.SetLinkConfig(clientIndex, LinkDirection::UPLINK, config_.uplink);
+        server.SetLinkConfig(clientIndex, LinkDirection::DOWNLINK, config_.downlink);
+    }
+    for (auto& client : clients)
+    {
+        client = std::make_unique<SimulationClient>(server);
+        client->SetHeadless(true);
+        client->SetInputDelayMode(InputDelayMode::FIXED, config_.inputDelay);
+        client->Begin();
+    }
+    if (!config_.recordPath.empty())
+    {
+        server.StartRecording(config_.recordPath);
+    }
+    server.OpenRelayStream();
+    server.Begin();
+    for (auto& client : clients)
+    {
+        client->Join();
+    }
+
+    //The bots use their own random engine, so changing the network does not change their inputs
+    std::seed_seq botSeed{ config_.seed, 1u };
+    std::mt19937 botRandomEngine(botSeed);
+    std::uniform_int_distribution<unsigned> inputDistribution(0u,
+        PlayerInputEnum::UP | PlayerInputEnum::DOWN | PlayerInputEnum::LEFT | PlayerInputEnum::RIGHT | PlayerInputEnum::SHOOT);
+    std::uniform_int_distribution<Frame> inputPeriodDistribution(1u, std::max(1u, 2u * config_.randomInputPeriod));
+    std::array<PlayerInput, maxPlayerNmb> botInputs{};
+    std::array<Frame, maxPlayerNmb> nextInputFrames{};
+    std::size_t nextScriptedInput = 0;
+
+    std::deque<ValidatedState> validatedStates;
+    std::array<Frame, maxPlayerNmb> lastCheckedFrames{};
+    std::uint64_t rollbackDepthSum = 0;
+    std::uint64_t rollbackDepthCount = 0;
+    //The server validates the frames in batches of various sizes, the batch checker validates the same inputs
+    //one frame at a time and must reach the same states with the same entity numbers
+    GameManager batchGameManager;
+    bool isBatchPlayerSpawned = false;
+    //The relay stream of the server is followed by a spectator, as the relays and the spectate tool do
+    SpectatorStream relayStream;
+    SpectatorCursor spectatorCursor;
+    MatchRecording spectatorRecording;
+    std::unique_ptr<ReplayPlayer> spectatorPlayer;
+    const auto updateSpectator = [&server, &relayStream, &spectatorCursor, &spectatorRecording, &spectatorPlayer]()
+    {
+        const auto time = GetClockTime();
+        const auto& streamData = server.GetRelayStreamData();
+        if (!streamData.empty())
+        {
+            if (!relayStream.Append(streamData.data(), streamData.size(), time))
+            {
+                return false;
+            }
+            server.ClearRelayStreamData();
+        }
+        relayStream.Update(time);
+        for (auto data = relayStream.GetPendingData(spectatorCursor); !data.empty(); data = relayStream.GetPendingData(spectatorCursor))
+        {
+            if (!spectatorRecording.Append(data.data(), data.size()))
+            {
+                return false;
+            }
+            SpectatorStream::Consume(spectatorCursor, data.size());
+        }
+        if (spectatorPlayer == nullptr && !spectatorRecording.GetKeyframes().empty())
+        {
+            spectatorPlayer = std::make_unique<ReplayPlayer>(spectatorRecording);
+            if (!spectatorPlayer->IsValid())
+            {
+                return false;
+            }
+        }
+        if (spectatorPlayer != nullptr)
+        {
+            spectatorPlayer->Advance(spectatorRecording.GetLastFrame() - spectatorPlayer->GetFrame());
+        }
+        return true;
+    };
+    bool isSpectatorValid = true;
+    bool isStateHistoryDumped = false;
+    //The state histories of all the peers are dumped once, when the first desync is found, for desync_bisect
+    const auto dumpStateHistories = [this, &clients, &server, &isStateHistoryDumped]()
+    {
+        if (config_.dumpDirectory.empty() || isStateHistoryDumped)
+        {
+            return;
+        }
+        isStateHistoryDumped = true;
+        server.GetGameManager().GetRollbackManager().GetStateHistory().Dump(
+            fmt::format("{}/match_{}_server.hash", config_.dumpDirectory, config_.seed));
+        for (const auto& client : clients)
+        {
+            const auto& gameManager = client->GetGameManager();
+            gameManager.GetRollbackManager().GetStateHistory().Dump(
+                fmt::format("{}/match_{}_p{}.hash", config_.dumpDirectory, config_.seed, gameManager.GetPlayerNumber() + 1));
+        }
+    };
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    try
+    {
+        while (true)
+        {
+            simulatedClockTime.fetch_add(fixedPeriodMs, std::memory_order_relaxed);
+            for (auto& client : clients)
+            {
+                const auto& gameManager = client->GetGameManager();
+                const auto playerNumber = gameManager.GetPlayerNumber();
+                if (playerNumber == INVALID_PLAYER || !(gameManager.GetState() & ClientGameManager::STARTED))
+                {
+                    continue;
+                }
+                const auto currentFrame = gameManager.GetCurrentFrame();
+                if (config_.inputScript.empty())
+                {
+                    if (currentFrame >= nextInputFrames[playerNumber])
+                    {
+                        botInputs[playerNumber] = static_cast<PlayerInput>(inputDistribution(botRandomEngine));
+                        nextInputFrames[playerNumber] = currentFrame + inputPeriodDistribution(botRandomEngine);
+                    }
+                }
+                else
+                {
+                    while (nextScriptedInput < config_.inputScript.size() &&
+                        config_.inputScript[nextScriptedInput].frame <= currentFrame)
+                    {
+                        const auto& scriptedInput = config_.inputScript[nextScriptedInput];
+                        botInputs[scriptedInput.playerNumber] = scriptedInput.input;
+                        nextScriptedInput++;
+                    }
+                }
+                client->SetPlayerInput(botInputs[playerNumber]);
+            }
+
+            server.Update(dt);
+            isSpectatorValid = isSpectatorValid && updateSpectator();
+            const auto& serverRollbackManager = server.GetGameManager().GetRollbackManager();
+            const auto serverValidateFrame = serverRollbackManager.GetLastValidateFrame();
+            if (serverValidateFrame > 0 && (validatedStates.empty() || validatedStates.back().frame < serverValidateFrame))
+            {
+                auto& validatedState = validatedStates.emplace_back();
+                validatedState.frame = serverValidateFrame;
+                for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+                {
+                    validatedState.physicsStates[playerNumber] = serverRollbackManager.GetValidatePhysicsState(playerNumber);
+                }
+
+                if (!isBatchPlayerSpawned)
+                {
+                    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+                    {
+                        batchGameManager.SpawnPlayer(playerNumber, spawnPositions[playerNumber] * 3.0f, spawnRotations[playerNumber]);
+                    }
+                    isBatchPlayerSpawned = true;
+                }
+                const auto serverCurrentFrame = serverRollbackManager.GetCurrentFrame();
+                for (Frame frame = batchGameManager.GetLastValidateFrame() + 1; frame <= serverValidateFrame; frame++)
+                {
+                    for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+                    {
+                        batchGameManager.SetPlayerInput(playerNumber,
+                            serverRollbackManager.GetInputs(playerNumber)[serverCurrentFrame - frame], frame);
+                    }
+                    batchGameManager.Validate(frame);
+                }
+                const auto* serverState = serverRollbackManager.GetStateHistory().FindFrameState(serverValidateFrame);
+                const auto* batchState = batchGameManager.GetRollbackManager().GetStateHistory().FindFrameState(serverValidateFrame);
+                if (serverState == nullptr || batchState == nullptr ||
+                    serverState->hashes != batchState->hashes || serverState->values != batchState->values)
+                {
+                    report.batchDesyncNmb++;
+                }
+            }
+
+            bool isFinished = false;
+            for (std::size_t i = 0; i < clients.size(); i++)
+            {
+                clients[i]->Update(dt);
+                const auto& gameManager = clients[i]->GetGameManager();
+                if (!(gameManager.GetState() & ClientGameManager::STARTED))
+                {
+                    continue;
+                }
+                //Every frame is resimulated from the last validated frame
+                const auto rollbackDepth = gameManager.GetCurrentFrame() - gameManager.GetLastValidateFrame();
+                report.maxRollbackDepth = std::max(report.maxRollbackDepth, rollbackDepth);
+                rollbackDepthSum += rollbackDepth;
+                rollbackDepthCount++;
+                report.frameNmb = std::max(report.frameNmb, gameManager.GetCurrentFrame());
+
+                const auto clientValidateFrame = gameManager.GetLastValidateFrame();
+                if (clientValidateFrame > lastCheckedFrames[i])
+                {
+                    lastCheckedFrames[i] = clientValidateFrame;
+                    const auto validatedStateIt = std::find_if(validatedStates.begin(), validatedStates.end(),
+                        [clientValidateFrame](const auto& validatedState)
+                        {
+                            return validatedState.frame == clientValidateFrame;
+                        });
+                    //Frames validated in the same server step are not recorded, the client assertion still checks them
+                    if (validatedStateIt != validatedStates.end())
+                    {
+                        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+                        {
+                            if (validatedStateIt->physicsStates[playerNumber] !=
+                                gameManager.GetRollbackManager().GetValidatePhysicsState(playerNumber))
+                            {
+                                report.desyncNmb++;
+                                dumpStateHistories();
+                                break;
+                            }
+                        }
+                    }
+                }
+                isFinished = isFinished || (gameManager.GetState() & ClientGameManager::FINISHED);
+            }
+            const auto oldestCheckedFrame = *std::min_element(lastCheckedFrames.begin(), lastCheckedFrames.end());
+            while (!validatedStates.empty() && validatedStates.front().frame < oldestCheckedFrame)
+            {
+                validatedStates.pop_front();
+            }
+            if (isFinished || report.frameNmb >= config_.maxFrameNmb)
+            {
+                break;
+            }
+        }
+    }
+    catch (const core::AssertException& e)
+    {
+        report.error = e.what();
+        dumpStateHistories();
+    }
+    const auto wallEnd = std::chrono::steady_clock::now();
+
+    for (auto& client : clients)
+    {
+        client->End();
+    }
+    server.End();
+    server.StopRecording();
+    SetClockFunction(nullptr);
+
+    report.winner = server.GetGameManager().CheckWinner();
+    isSpectatorValid = isSpectatorValid && updateSpectator();
+    const auto serverValidateFrame = server.GetGameManager().GetLastValidateFrame();
+    if (spectatorPlayer != nullptr)
+    {
+        report.spectatorDesyncNmb = spectatorPlayer->GetDesyncNmb();
+    }
+    //The spectator is only checked if no assertion stopped the match
+    if (report.error.empty())
+    {
+        if (!isSpectatorValid)
+        {
+            report.error = "the relay stream is not a valid recording";
+        }
+        else if (spectatorPlayer == nullptr || spectatorPlayer->GetFrame() != serverValidateFrame)
+        {
+            report.error = fmt::format("the spectator stopped at frame {} instead of {}",
+                spectatorPlayer == nullptr ? 0 : spectatorPlayer->GetFrame(), serverValidateFrame);
+        }
+        else if (spectatorRecording.GetWinner() != report.winner ||
+            (report.winner != INVALID_PLAYER && spectatorRecording.GetRecords().back().type != MatchRecordType::END))
+        {
+            report.error = "the spectator did not receive the end of the match";
+        }
+    }
+    report.wallTime = std::chrono::duration<double>(wallEnd - wallStart).count();
+    report.framesPerSecond = report.wallTime > 0.0 ? static_cast<double>(report.frameNmb) / report.wallTime : 0.0;
+    report.meanRollbackDepth = rollbackDepthCount > 0 ?
+        static_cast<double>(rollbackDepthSum) / static_cast<double>(rollbackDepthCount) : 0.0;
+    return report;
+}
+}
@@ -42,6 +42,8 @@ void NetworkClient::Update(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    //Sockets and received packets are shared with the simulation thread sending the inputs
+    std::unique_lock lock(gameManager_.GetSimulationMutex());
     Client::Update(dt);
     if (currentState_ != State::NONE)
     {
@@ -110,6 +112,11 @@ void NetworkClient::Update(sf::Time dt)
             break;
         }
     }
+    lock.unlock();
+#ifdef TRACY_ENABLE
+    TracyPlot("Client Sent Bytes", static_cast<std::int64_t>(sentBytes_.load(std::memory_order_relaxed)));
+    TracyPlot("Client Received Bytes", static_cast<std::int64_t>(receivedBytes_.load(std::memory_order_relaxed)));
+#endif
 
     gameManager_.Update(dt);
 }
@@ -135,9 +142,14 @@ void NetworkClient::DrawImGui()
         ImGui::Text("RTTVAR: %f", rttvar_);
         ImGui::Text("RTO: %f", rto_);
     }
+    ImGui::Text("Sent: %llu B Received: %llu B",
+        static_cast<unsigned long long>(sentBytes_.load(std::memory_order_relaxed)),
+        static_cast<unsigned long long>(receivedBytes_.load(std::memory_order_relaxed)));
+    DrawInputDelayImGui();
+    DrawClockSyncImGui();
 
 
-    ImGui::InputText("Host", &serverAddress_);
+    ImGui::InputText("Host", &hostInput_);
 
     int portBuffer = serverTcpPort_;
     if (ImGui::InputInt("Port", &portBuffer))
@@ -147,23 +159,23 @@ void NetworkClient::DrawImGui()
     if (currentState_ == State::NONE &&
         ImGui::Button("Join"))
     {
+        //The TCP socket is not used by the other threads before joining, the blocking connect does not stall the simulation
         tcpSocket_.setBlocking(true);
-        const auto status = tcpSocket_.connect(serverAddress_, serverTcpPort_);
+        const auto status = tcpSocket_.connect(hostInput_, serverTcpPort_);
         tcpSocket_.setBlocking(false);
         if (status == sf::Socket::Done)
         {
-            core::LogDebug("[Client] Connect to server " + serverAddress_ + " with port: " + std::to_string(serverTcpPort_));
+            core::LogDebug("[Client] Connect to server " + hostInput_ + " with port: " + std::to_string(serverTcpPort_));
+            std::scoped_lock lock(gameManager_.GetSimulationMutex());
+            serverAddress_ = hostInput_;
             auto joinPacket = std::make_unique<JoinPacket>();
             joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-            using namespace std::chrono;
-            const unsigned long clientTime = static_cast<unsigned long>((duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count());
-            joinPacket->startTime = core::ConvertToBinary<unsigned long>(clientTime);
             SendReliablePacket(std::move(joinPacket));
             currentState_ = State::JOINING;
         }
         else
         {
-            core::LogError("[Client] Error trying to connect to " + serverAddress_ + " with port: " +
+            core::LogError("[Client] Error trying to connect to " + hostInput_ + " with port: " +
                 std::to_string(serverTcpPort_) + " with status: " + std::to_string(status));
         }
     }
@@ -186,6 +198,7 @@ void NetworkClient::SendReliablePacket(std::unique_ptr<Packet> packet)
     //core::LogDebug("[Client] Sending reliable packet to server");
     sf::Packet tcpPacket;
     GeneratePacket(tcpPacket, *packet);
+    sentBytes_.fetch_add(tcpPacket.getDataSize(), std::memory_order_relaxed);
     auto status = sf::Socket::Partial;
     while (status == sf::Socket::Partial)
     {
@@ -202,6 +215,7 @@ void NetworkClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
     }
     sf::Packet udpPacket;
     GeneratePacket(udpPacket, *packet);
+    sentBytes_.fetch_add(udpPacket.getDataSize(), std::memory_order_relaxed);
     const auto status = udpSocket_.send(udpPacket, serverAddress_, serverUdpPort_);
     switch (status)
     {
@@ -228,11 +242,7 @@ void NetworkClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
 
 void NetworkClient::SetPlayerInput(PlayerInput playerInput)
 {
-    const auto currentFrame = gameManager_.GetCurrentFrame();
-    gameManager_.SetPlayerInput(
-        gameManager_.GetPlayerNumber(),
-        playerInput,
-        currentFrame);
+    gameManager_.SetLocalPlayerInput(playerInput);
 }
 
 void NetworkClient::ReceivePacket(const Packet* packet)
@@ -273,6 +283,7 @@ void NetworkClient::ReceivePacket(const Packet* packet)
     case PacketType::JOIN_ACK: break;
     case PacketType::WIN_GAME: break;
     case PacketType::PING: break;
+    case PacketType::FRAME_ADVANTAGE: break;
     case PacketType::NONE: break;
     default:;
     }
@@ -281,6 +292,7 @@ void NetworkClient::ReceivePacket(const Packet* packet)
 
 void NetworkClient::ReceiveNetPacket(sf::Packet& packet, PacketSource source)
 {
+    receivedBytes_.fetch_add(packet.getDataSize(), std::memory_order_relaxed);
     const auto receivePacket = GenerateReceivedPacket(packet);
     Client::ReceivePacket(receivePacket.get());
     switch (receivePacket->packetType)
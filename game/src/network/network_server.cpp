@@ -1,4 +1,5 @@
 #include <network/network_server.h>
+#include "network/clock_sync.h"
 #include "utils/log.h"
 #include "utils/conversion.h"
 #include "utils/assert.h"
@@ -22,6 +23,7 @@ void NetworkServer::SendReliablePacket(
     {
         sf::Packet sendingPacket;
         GeneratePacket(sendingPacket, *packet);
+        sentBytes_ += sendingPacket.getDataSize();
 
         auto status = sf::Socket::Partial;
         while (status == sf::Socket::Partial)
@@ -57,6 +59,7 @@ void NetworkServer::SendUnreliablePacket(
 
         sf::Packet sendingPacket;
         GeneratePacket(sendingPacket, *packet);
+        sentBytes_ += sendingPacket.getDataSize();
         const auto status = udpSocket_.send(sendingPacket, clientInfoMap_[playerNumber].udpRemoteAddress,
             clientInfoMap_[playerNumber].udpRemotePort);
         switch (status)
@@ -121,6 +124,10 @@ void NetworkServer::Begin()
     udpSocket_.setBlocking(false);
     core::LogDebug(fmt::format("[Server] Udp Socket on port: {}", udpPort_));
 
+    relayPort_ = relayListener_.Listen(relayPort_);
+    OpenRelayStream();
+    core::LogDebug(fmt::format("[Server] Relay Socket on port: {}", relayPort_));
+
     status_ = status_ | OPEN;
 
 }
@@ -178,11 +185,19 @@ void NetworkServer::Update([[maybe_unused]] sf::Time dt)
     {
         ReceiveNetPacket(udpPacket, PacketSocketSource::UDP, address, port);
     }
+    UpdateRelays();
+#ifdef TRACY_ENABLE
+    TracyPlot("Server Sent Bytes", static_cast<std::int64_t>(sentBytes_));
+    TracyPlot("Server Received Bytes", static_cast<std::int64_t>(receivedBytes_));
+#endif
 }
 
 void NetworkServer::End()
 {
-
+    //The end of the match is sent to the relays before closing
+    UpdateRelays();
+    relayListener_.Flush();
+    relayRecorder_.Close();
 }
 
 void NetworkServer::SetTcpPort(unsigned short i)
@@ -190,6 +205,11 @@ void NetworkServer::SetTcpPort(unsigned short i)
     tcpPort_ = i;
 }
 
+void NetworkServer::SetRelayPort(unsigned short port)
+{
+    relayPort_ = port;
+}
+
 bool NetworkServer::IsOpen() const
 {
     return status_ & OPEN;
@@ -259,12 +279,6 @@ void NetworkServer::ProcessReceivePacket(
         else
         {
             SendReliablePacket(std::move(joinAckPacket));
-            //Calculate time difference
-            const auto clientTime = core::ConvertFromBinary<unsigned long>(joinPacket.startTime);
-            using namespace std::chrono;
-            const unsigned long deltaTime = static_cast<unsigned long>((duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count())) - clientTime;
-            core::LogDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
-            clientInfoMap_[playerNumber].timeDifference = deltaTime;
         }
         break;
     }
@@ -274,11 +288,28 @@ void NetworkServer::ProcessReceivePacket(
     }
 }
 
+void NetworkServer::UpdateRelays()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto time = GetClockTime();
+    const auto& streamData = GetRelayStreamData();
+    if (!streamData.empty())
+    {
+        relayListener_.Append(streamData.data(), streamData.size(), time);
+        ClearRelayStreamData();
+    }
+    relayListener_.Update(time);
+}
+
 void NetworkServer::ReceiveNetPacket(sf::Packet& packet,
     PacketSocketSource packetSource,
     sf::IpAddress address,
     unsigned short port)
 {
+    receivedBytes_ += packet.getDataSize();
     auto receivedPacket = GenerateReceivedPacket(packet);
 
     if (receivedPacket != nullptr)
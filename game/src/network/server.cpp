@@ -1,7 +1,9 @@
 #include <network/server.h>
+#include <network/clock_sync.h>
 #include <utils/log.h>
 #include <fmt/format.h>
 #include <utils/conversion.h>
+#include <algorithm>
 #include <cstdint>
 
 #ifdef TRACY_ENABLE
@@ -41,8 +43,11 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
             {
                 auto startGamePacket = std::make_unique<StartGamePacket>();
                 startGamePacket->packetType = PacketType::START_GAME;
+                startGamePacket->startTime = core::ConvertToBinary(GetClockTime() + startDelay);
                 core::LogDebug("Send Start Game Packet");
                 SendReliablePacket(std::move(startGamePacket));
+                //The first keyframe is the world with all the spawned players
+                RecordKeyframe();
             }
 
             break;
@@ -53,6 +58,13 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
         const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet.get());
         const auto playerNumber = playerInputPacket->playerNumber;
         const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+        const auto simulationFrame = core::ConvertFromBinary<Frame>(playerInputPacket->simulationFrame);
+        //Unreliable packets can arrive out of order, only the most recent frame is kept
+        if (simulationFrame >= lastSimulationFrames_[playerNumber])
+        {
+            lastSimulationFrames_[playerNumber] = simulationFrame;
+            lastInputTimes_[playerNumber] = GetClockTime();
+        }
 
         for (std::uint32_t i = 0; i < playerInputPacket->inputs.size(); i++)
         {
@@ -77,10 +89,16 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
                 lastReceiveFrame = playerLastFrame;
             }
         }
-        if (lastReceiveFrame > gameManager_.GetLastValidateFrame())
+        const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
+        if (lastReceiveFrame > lastValidateFrame)
         {
             //Validate frame
             gameManager_.Validate(lastReceiveFrame);
+            RecordFrames(lastValidateFrame + 1, lastReceiveFrame);
+            if (lastReceiveFrame / recordingKeyframePeriod > lastValidateFrame / recordingKeyframePeriod)
+            {
+                RecordKeyframe();
+            }
 
             auto validatePacket = std::make_unique<ValidateFramePacket>();
             validatePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
@@ -104,6 +122,13 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
                 winGamePacket->winner = winner;
                 SendReliablePacket(std::move(winGamePacket));
                 gameManager_.WinGame(winner);
+                RecordEnd(lastReceiveFrame, winner);
+                StopRecording();
+            }
+            if (lastReceiveFrame >= lastFrameAdvantageFrame_ + frameAdvantagePeriod)
+            {
+                lastFrameAdvantageFrame_ = lastReceiveFrame;
+                SendFrameAdvantages();
             }
         }
 
@@ -113,10 +138,71 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
     {
         auto pingPacket = std::make_unique<PingPacket>();
         *pingPacket = *static_cast<PingPacket*>(packet.get());
+        pingPacket->serverTime = core::ConvertToBinary(GetClockTime());
         SendUnreliablePacket(std::move(pingPacket));
         break;
     }
     default: break;
     }
 }
+
+bool Server::StartRecording(std::string_view path)
+{
+    return recorder_.Open(path);
+}
+
+void Server::StopRecording()
+{
+    recorder_.Close();
+}
+
+void Server::OpenRelayStream()
+{
+    relayRecorder_.OpenStream();
+}
+
+void Server::RecordKeyframe()
+{
+    recorder_.RecordKeyframe(gameManager_);
+    relayRecorder_.RecordKeyframe(gameManager_);
+}
+
+void Server::RecordFrames(Frame firstFrame, Frame lastFrame)
+{
+    recorder_.RecordFrames(gameManager_.GetRollbackManager(), firstFrame, lastFrame);
+    relayRecorder_.RecordFrames(gameManager_.GetRollbackManager(), firstFrame, lastFrame);
+}
+
+void Server::RecordEnd(Frame frame, PlayerNumber winner)
+{
+    recorder_.RecordEnd(frame, winner);
+    relayRecorder_.RecordEnd(frame, winner);
+}
+
+void Server::SendFrameAdvantages()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto now = GetClockTime();
+    std::array<float, maxPlayerNmb> estimatedFrames{};
+    float frameSum = 0.0f;
+    for (PlayerNumber i = 0; i < maxPlayerNmb; i++)
+    {
+        //The client kept simulating since its last input was received
+        const auto elapsed = static_cast<float>(now - lastInputTimes_[i]) / 1000.0f;
+        estimatedFrames[i] = static_cast<float>(lastSimulationFrames_[i]) + elapsed / fixedPeriod;
+        frameSum += estimatedFrames[i];
+    }
+    auto frameAdvantagePacket = std::make_unique<FrameAdvantagePacket>();
+    for (PlayerNumber i = 0; i < maxPlayerNmb; i++)
+    {
+        const float othersMeanFrame = (frameSum - estimatedFrames[i]) / static_cast<float>(maxPlayerNmb - 1);
+        const auto frameAdvantage = core::ConvertToBinary(estimatedFrames[i] - othersMeanFrame);
+        std::copy(frameAdvantage.begin(), frameAdvantage.end(),
+            frameAdvantagePacket->frameAdvantages.begin() + i * sizeof(float));
+    }
+    SendUnreliablePacket(std::move(frameAdvantagePacket));
+}
 }
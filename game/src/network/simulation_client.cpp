@@ -66,27 +66,28 @@ void SimulationClient::Draw(sf::RenderTarget& renderTarget)
 
 void SimulationClient::SetPlayerInput(PlayerInput playerInput)
 {
-    const auto currentFrame = gameManager_.GetCurrentFrame();
-    gameManager_.SetPlayerInput(
-        gameManager_.GetPlayerNumber(),
-        playerInput,
-        currentFrame);
+    gameManager_.SetLocalPlayerInput(playerInput);
 
 }
 
+void SimulationClient::Join()
+{
+    auto joinPacket = std::make_unique<JoinPacket>();
+    const auto* clientIdPtr = reinterpret_cast<std::uint8_t*>(&clientId_);
+    for (std::size_t i = 0; i < sizeof(clientId_); i++)
+    {
+        joinPacket->clientId[i] = clientIdPtr[i];
+    }
+    SendReliablePacket(std::move(joinPacket));
+}
+
 void SimulationClient::DrawImGui()
 {
     const auto windowName = "Client " + std::to_string(static_cast<unsigned>(clientId_));
     ImGui::Begin(windowName.c_str());
     if (gameManager_.GetPlayerNumber() == INVALID_PLAYER && ImGui::Button("Spawn Player"))
     {
-        auto joinPacket = std::make_unique<JoinPacket>();
-        const auto* clientIdPtr = reinterpret_cast<std::uint8_t*>(&clientId_);
-        for (std::size_t i = 0; i < sizeof(clientId_); i++)
-        {
-            joinPacket->clientId[i] = clientIdPtr[i];
-        }
-        SendReliablePacket(std::move(joinPacket));
+        Join();
     }
     gameManager_.DrawImGui();
     if (srtt_ > 0.0f)
@@ -95,21 +96,24 @@ void SimulationClient::DrawImGui()
         ImGui::Text("RTTVAR: %f", rttvar_);
         ImGui::Text("RTO: %f", rto_);
     }
+    DrawInputDelayImGui();
+    DrawClockSyncImGui();
     ImGui::End();
 }
 
 void SimulationClient::SendUnreliablePacket(std::unique_ptr<Packet> packet)
 {
-    server_.PutPacketInReceiveQueue(std::move(packet),true);
+    server_.PutPacketInReceiveQueue(*this, std::move(packet), true);
 }
 
 void SimulationClient::SendReliablePacket(std::unique_ptr<Packet> packet)
 {
-    server_.PutPacketInReceiveQueue(std::move(packet),false);
+    server_.PutPacketInReceiveQueue(*this, std::move(packet), false);
 }
 
 void SimulationClient::ReceivePacket(const Packet* packet)
 {
+    std::scoped_lock lock(gameManager_.GetSimulationMutex());
     Client::ReceivePacket(packet);
 #ifdef ENABLE_SQLITE
     switch (packet->packetType)
@@ -146,6 +150,7 @@ void SimulationClient::ReceivePacket(const Packet* packet)
     case PacketType::JOIN_ACK: break;
     case PacketType::WIN_GAME: break;
     case PacketType::PING: break;
+    case PacketType::FRAME_ADVANTAGE: break;
     case PacketType::NONE: break;
     default:;
     }
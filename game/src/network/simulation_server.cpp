@@ -1,7 +1,10 @@
 #include <network/simulation_server.h>
+
+#include <algorithm>
+
 #include <network/simulation_client.h>
 #include <imgui.h>
-#include <maths/basic.h>
+#include <utils/assert.h>
 #include <utils/conversion.h>
 #include <utils/log.h>
 
@@ -11,6 +14,19 @@
 
 namespace game
 {
+namespace
+{
+/**
+ * \brief GetPacketSize is a function that returns the size of the serialized packet, as sent on a socket.
+ */
+std::size_t GetPacketSize(Packet& packet)
+{
+    sf::Packet serializedPacket;
+    GeneratePacket(serializedPacket, packet);
+    return serializedPacket.getDataSize();
+}
+}
+
 SimulationServer::SimulationServer(std::array<std::unique_ptr<SimulationClient>, 2>& clients) : clients_(clients)
 {
 }
@@ -26,41 +42,30 @@ void SimulationServer::Update(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    auto packetIt = receivedPackets_.begin();
-    while (packetIt != receivedPackets_.end())
+    currentTime_ += dt.asSeconds();
+    while (receivedPackets_.IsDue(currentTime_))
     {
-        packetIt->currentTime -= dt.asSeconds();
-        if (packetIt->currentTime <= 0.0f)
-        {
-            ProcessReceivePacket(std::move(packetIt->packet));
-
-            packetIt = receivedPackets_.erase(packetIt);
-        }
-        else
-        {
-            ++packetIt;
-        }
-
+        ProcessReceivePacket(receivedPackets_.Pop());
     }
 
-    packetIt = sentPackets_.begin();
-    while (packetIt != sentPackets_.end())
+    for (std::size_t clientIndex = 0; clientIndex < clients_.size(); clientIndex++)
     {
-        packetIt->currentTime -= dt.asSeconds();
-        if (packetIt->currentTime <= 0.0f)
+        auto& sentPackets = sentPackets_[clientIndex];
+        while (sentPackets.IsDue(currentTime_))
         {
-            for (auto& client : clients_)
-            {
-                client->ReceivePacket(packetIt->packet.get());
-            }
-            packetIt->packet = nullptr;
-            packetIt = sentPackets_.erase(packetIt);
-        }
-        else
-        {
-            ++packetIt;
+            const auto packet = sentPackets.Pop();
+            clients_[clientIndex]->ReceivePacket(packet.get());
         }
     }
+#ifdef TRACY_ENABLE
+    std::size_t sentQueueSize = 0;
+    for (const auto& sentPackets : sentPackets_)
+    {
+        sentQueueSize += sentPackets.Size();
+    }
+    TracyPlot("Server Received Queue", static_cast<std::int64_t>(receivedPackets_.Size()));
+    TracyPlot("Server Sent Queue", static_cast<std::int64_t>(sentQueueSize));
+#endif
 }
 
 void SimulationServer::End()
@@ -70,46 +75,125 @@ void SimulationServer::End()
 void SimulationServer::DrawImGui()
 {
     ImGui::Begin("Server");
-    float minDelay = avgDelay_ - marginDelay_;
-    float maxDelay = avgDelay_ + marginDelay_;
+    float minDelay = linkConfig_.delay - linkConfig_.jitter;
+    float maxDelay = linkConfig_.delay + linkConfig_.jitter;
     bool hasDelayChanged = false;
-    hasDelayChanged = hasDelayChanged || ImGui::SliderFloat("Min Delay", &minDelay, 0.01f, maxDelay);
-    hasDelayChanged = hasDelayChanged || ImGui::SliderFloat("Max Delay", &maxDelay, minDelay, 1.0f);
+    hasDelayChanged = ImGui::SliderFloat("Min Delay", &minDelay, 0.01f, maxDelay) || hasDelayChanged;
+    hasDelayChanged = ImGui::SliderFloat("Max Delay", &maxDelay, minDelay, 1.0f) || hasDelayChanged;
     if (hasDelayChanged)
     {
-        avgDelay_ = (maxDelay + minDelay) / 2.0f;
-        marginDelay_ = (maxDelay - minDelay) / 2.0f;
+        linkConfig_.delay = (maxDelay + minDelay) / 2.0f;
+        linkConfig_.jitter = (maxDelay - minDelay) / 2.0f;
+    }
+    bool hasLinkChanged = hasDelayChanged;
+    const char* jitterDistributions[] = { "Uniform", "Normal", "Exponential" };
+    int jitterDistribution = static_cast<int>(linkConfig_.jitterDistribution);
+    if (ImGui::Combo("Jitter", &jitterDistribution, jitterDistributions, static_cast<int>(std::size(jitterDistributions))))
+    {
+        linkConfig_.jitterDistribution = static_cast<JitterDistribution>(jitterDistribution);
+        hasLinkChanged = true;
+    }
+    hasLinkChanged = ImGui::SliderFloat("Packet Loss", &linkConfig_.lossGood, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Burst Loss", &linkConfig_.lossBad, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Burst Start", &linkConfig_.goodToBad, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Burst End", &linkConfig_.badToGood, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Duplicate", &linkConfig_.duplicateRate, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Reorder", &linkConfig_.reorderRate, 0.0f, 1.0f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Reorder Delay", &linkConfig_.reorderDelay, 0.0f, 0.5f) || hasLinkChanged;
+    hasLinkChanged = ImGui::SliderFloat("Bandwidth (B/s)", &linkConfig_.bandwidth, 0.0f, 100000.0f) || hasLinkChanged;
+    if (hasLinkChanged)
+    {
+        SetLinkConfig(linkConfig_);
     }
-    ImGui::SliderFloat("Packet Loss", &packetLoss_, 0.0f, 1.0f);
     ImGui::End();
 }
 
-void SimulationServer::PutPacketInSendingQueue(std::unique_ptr<Packet> packet)
+void SimulationServer::SetSeed(std::uint32_t seed)
 {
-    sentPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), std::move(packet) });
+    for (std::size_t clientIndex = 0; clientIndex < maxPlayerNmb; clientIndex++)
+    {
+        uplinks_[clientIndex].SetSeed(seed, static_cast<std::uint32_t>(2 * clientIndex));
+        downlinks_[clientIndex].SetSeed(seed, static_cast<std::uint32_t>(2 * clientIndex + 1));
+    }
 }
 
-void SimulationServer::PutPacketInReceiveQueue(std::unique_ptr<Packet> packet, bool unreliable)
+void SimulationServer::SetLinkConfig(const LinkConfig& linkConfig)
 {
-    if(unreliable)
+    linkConfig_ = linkConfig;
+    for (std::size_t clientIndex = 0; clientIndex < maxPlayerNmb; clientIndex++)
     {
-        //Packet loss implementation
-        if(core::RandomRange(0.0f, 1.0f) < packetLoss_)
+        uplinks_[clientIndex].SetConfig(linkConfig);
+        downlinks_[clientIndex].SetConfig(linkConfig);
+    }
+}
+
+void SimulationServer::SetLinkConfig(std::size_t clientIndex, LinkDirection direction, const LinkConfig& linkConfig)
+{
+    GetLinkModel(clientIndex, direction).SetConfig(linkConfig);
+}
+
+void SimulationServer::PutPacketInSendingQueue(std::unique_ptr<Packet> packet, bool unreliable)
+{
+    std::size_t packetSize = 0;
+    if (std::any_of(downlinks_.begin(), downlinks_.end(), [](const auto& downlink) { return downlink.GetConfig().bandwidth > 0.0f; }))
+    {
+        packetSize = GetPacketSize(*packet);
+    }
+    const std::shared_ptr<const Packet> sentPacket = std::move(packet);
+    for (std::size_t clientIndex = 0; clientIndex < clients_.size(); clientIndex++)
+    {
+        const auto transmission = downlinks_[clientIndex].Transmit(currentTime_, packetSize, !unreliable);
+        for (std::size_t i = 0; i < transmission.copyNmb; i++)
         {
-            return;
+            sentPackets_[clientIndex].Push(transmission.deliveryTimes[i], sentPacket);
         }
     }
-    receivedPackets_.push_back({ avgDelay_ + core::RandomRange(-marginDelay_, marginDelay_), std::move(packet) });
+}
+
+void SimulationServer::PutPacketInReceiveQueue(const SimulationClient& client, std::unique_ptr<Packet> packet, bool unreliable)
+{
+    auto& uplink = uplinks_[GetClientIndex(client)];
+    const auto packetSize = uplink.GetConfig().bandwidth > 0.0f ? GetPacketSize(*packet) : 0;
+    const auto transmission = uplink.Transmit(currentTime_, packetSize, !unreliable);
+    if (transmission.copyNmb > 1)
+    {
+        //The duplicate is read back from the bytes on the wire
+        sf::Packet duplicatePacket;
+        GeneratePacket(duplicatePacket, *packet);
+        if (auto duplicate = GenerateReceivedPacket(duplicatePacket); duplicate != nullptr)
+        {
+            receivedPackets_.Push(transmission.deliveryTimes[1], std::move(duplicate));
+        }
+    }
+    if (transmission.copyNmb > 0)
+    {
+        receivedPackets_.Push(transmission.deliveryTimes[0], std::move(packet));
+    }
 }
 
 void SimulationServer::SendReliablePacket(std::unique_ptr<Packet> packet)
 {
-    PutPacketInSendingQueue(std::move(packet));
+    PutPacketInSendingQueue(std::move(packet), false);
 }
 
 void SimulationServer::SendUnreliablePacket(std::unique_ptr<Packet> packet)
 {
-    PutPacketInSendingQueue(std::move(packet));
+    PutPacketInSendingQueue(std::move(packet), true);
+}
+
+std::size_t SimulationServer::GetClientIndex(const SimulationClient& client) const
+{
+    const auto clientIt = std::find_if(clients_.begin(), clients_.end(), [&client](const auto& simulationClient)
+    {
+        return simulationClient.get() == &client;
+    });
+    gpr_assert(clientIt != clients_.end(), "Packet sent by a client unknown to the SimulationServer");
+    return static_cast<std::size_t>(std::distance(clients_.begin(), clientIt));
+}
+
+LinkModel& SimulationServer::GetLinkModel(std::size_t clientIndex, LinkDirection direction)
+{
+    return direction == LinkDirection::UPLINK ? uplinks_[clientIndex] : downlinks_[clientIndex];
 }
 
 void SimulationServer::ProcessReceivePacket(std::unique_ptr<Packet> packet)
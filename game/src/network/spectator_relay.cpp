@@ -0,0 +1,214 @@
+#include "network/spectator_relay.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "network/clock_sync.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+bool SpectatorStream::Append(const std::byte* data, std::size_t size, long long time)
+{
+    if (!recording_.Append(data, size))
+    {
+        return false;
+    }
+    recordTimes_.resize(recording_.GetRecords().size(), time);
+    return true;
+}
+
+void SpectatorStream::Update(long long time)
+{
+    const auto& records = recording_.GetRecords();
+    while (visibleRecordNmb_ < records.size() && recordTimes_[visibleRecordNmb_] + broadcastDelay_ <= time)
+    {
+        const auto& record = records[visibleRecordNmb_];
+        if (record.type == MatchRecordType::KEYFRAME)
+        {
+            joinOffset_ = record.offset;
+            hasJoinKeyframe_ = true;
+        }
+        visibleSize_ = record.offset + record.size;
+        visibleRecordNmb_++;
+    }
+}
+
+std::span<const std::byte> SpectatorStream::GetPendingData(SpectatorCursor& cursor) const
+{
+    if (!cursor.isJoined)
+    {
+        if (!hasJoinKeyframe_)
+        {
+            return {};
+        }
+        cursor.isJoined = true;
+        cursor.headerOffset = 0;
+        cursor.offset = joinOffset_;
+    }
+    const auto& data = recording_.GetData();
+    if (cursor.headerOffset < matchRecordingHeaderSize)
+    {
+        return { data.data() + cursor.headerOffset, matchRecordingHeaderSize - cursor.headerOffset };
+    }
+    return { data.data() + cursor.offset, visibleSize_ - cursor.offset };
+}
+
+void SpectatorStream::Consume(SpectatorCursor& cursor, std::size_t size)
+{
+    const auto headerSize = std::min(size, matchRecordingHeaderSize - cursor.headerOffset);
+    cursor.headerOffset += headerSize;
+    cursor.offset += size - headerSize;
+}
+
+unsigned short SpectatorListener::Listen(unsigned short port)
+{
+    sf::Socket::Status status = sf::Socket::Error;
+    while (status != sf::Socket::Done)
+    {
+        status = listener_.listen(port);
+        if (status != sf::Socket::Done)
+        {
+            port++;
+        }
+    }
+    listener_.setBlocking(false);
+    return port;
+}
+
+void SpectatorListener::Update(long long time)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    stream_.Update(time);
+    while (listener_.accept(nextSpectator_->socket) == sf::Socket::Done)
+    {
+        nextSpectator_->socket.setBlocking(false);
+        core::LogDebug(fmt::format("[Relay] New spectator connection with address: {} and port: {}",
+            nextSpectator_->socket.getRemoteAddress().toString(), nextSpectator_->socket.getRemotePort()));
+        spectators_.push_back(std::move(nextSpectator_));
+        nextSpectator_ = std::make_unique<Spectator>();
+    }
+    isSending_ = false;
+    spectators_.erase(std::remove_if(spectators_.begin(), spectators_.end(),
+        [this](const auto& spectator)
+        {
+            return !Send(*spectator);
+        }), spectators_.end());
+#ifdef TRACY_ENABLE
+    TracyPlot("Relay Spectators", static_cast<std::int64_t>(spectators_.size()));
+#endif
+}
+
+void SpectatorListener::Flush()
+{
+    for (auto& spectator : spectators_)
+    {
+        spectator->socket.setBlocking(true);
+        Send(*spectator);
+    }
+    isSending_ = false;
+}
+
+bool SpectatorListener::Send(Spectator& spectator)
+{
+    auto data = stream_.GetPendingData(spectator.cursor);
+    while (!data.empty())
+    {
+        std::size_t sent = 0;
+        const auto status = spectator.socket.send(data.data(), data.size(), sent);
+        SpectatorStream::Consume(spectator.cursor, sent);
+        switch (status)
+        {
+        case sf::Socket::Done:
+            break;
+        case sf::Socket::NotReady:
+        case sf::Socket::Partial:
+            //The socket is full, the spectator is resumed on the next update
+            isSending_ = true;
+            return true;
+        default:
+            core::LogDebug(fmt::format("[Relay] Spectator with address: {} is disconnected",
+                spectator.socket.getRemoteAddress().toString()));
+            return false;
+        }
+        data = stream_.GetPendingData(spectator.cursor);
+    }
+    return true;
+}
+
+void SpectatorRelay::SetUpstream(const sf::IpAddress& address, unsigned short port)
+{
+    upstreamAddress_ = address;
+    upstreamPort_ = port;
+}
+
+void SpectatorRelay::Begin()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (upstreamSocket_.connect(upstreamAddress_, upstreamPort_) != sf::Socket::Done)
+    {
+        core::LogError(fmt::format("[Relay] Could not connect to the upstream {}:{}", upstreamAddress_.toString(), upstreamPort_));
+        return;
+    }
+    upstreamSocket_.setBlocking(false);
+    isUpstreamConnected_ = true;
+    listenPort_ = spectatorListener_.Listen(listenPort_);
+    core::LogDebug(fmt::format("[Relay] Spectator Socket on port: {}", listenPort_));
+}
+
+void SpectatorRelay::Update([[maybe_unused]] sf::Time dt)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto time = GetClockTime();
+    while (isUpstreamConnected_)
+    {
+        std::size_t received = 0;
+        const auto status = upstreamSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size(), received);
+        if (status == sf::Socket::Done)
+        {
+            if (!spectatorListener_.Append(receiveBuffer_.data(), received, time))
+            {
+                core::LogError("[Relay] The upstream does not stream a match of this version of the game");
+                upstreamSocket_.disconnect();
+                isUpstreamConnected_ = false;
+            }
+        }
+        else if (status == sf::Socket::NotReady)
+        {
+            break;
+        }
+        else
+        {
+            core::LogDebug("[Relay] Upstream is disconnected");
+            isUpstreamConnected_ = false;
+        }
+    }
+    spectatorListener_.Update(time);
+}
+
+void SpectatorRelay::End()
+{
+    spectatorListener_.Flush();
+    upstreamSocket_.disconnect();
+}
+
+bool SpectatorRelay::IsOpen() const
+{
+    return isUpstreamConnected_ || spectatorListener_.GetStream().HasHiddenRecords() || spectatorListener_.IsSending();
+}
+}